@@ -1,77 +1,57 @@
 #version 330 core
 out vec4 FragColor;
 
+// Bands the chunk contains (bit 0 = sand .. bit 3 = snow). TerrainManager injects one
+// value per permutation; absent bands are compiled out.
+#ifndef MATERIAL_LAYER_MASK
+#define MATERIAL_LAYER_MASK 15
+#endif
+
 in vec2 TexCoords;
 in vec3 WorldPos;
-in float Height;
+in vec4 MaterialWeights;   // sand, grass, rock, snow; sums to 1 before interpolation
+in vec3 Normal;            // smooth, from the CPU height grid
 
 // --- Texture Units ---
-uniform sampler2D sandAlbedo;
-uniform sampler2D sandNormal;
-uniform sampler2D sandRoughness;
-uniform sampler2D sandAO;
-
-uniform sampler2D grassAlbedo;
-uniform sampler2D grassNormal;
-uniform sampler2D grassRoughness;
-uniform sampler2D grassAO;
-
-uniform sampler2D rockAlbedo;
-uniform sampler2D rockNormal;
-uniform sampler2D rockRoughness;
-uniform sampler2D rockAO;
-
-uniform sampler2D snowAlbedo;
-uniform sampler2D snowNormal;
-uniform sampler2D snowRoughness;
-uniform sampler2D snowAO;
-
-// --- Thresholds ---
-uniform float sandHeight;
-uniform float grassHeight;
-uniform float rockHeight;
-uniform float snowHeight;
+// One layer per material set; bandLayers picks the layer for each height band
+uniform sampler2DArray materialAlbedo;
+uniform sampler2DArray materialNormal;
+uniform sampler2DArray materialORM;   // r = AO, g = roughness, b = displacement
+uniform int bandLayers[4];            // sand, grass, rock, snow
 
 // --- Lighting ---
 uniform vec3 lightPos;     
 uniform vec3 lightColor;   
 uniform vec3 viewPos;      
 
-// 计算TBN矩阵
-mat3 computeTBN(vec3 normal, vec3 worldPos, vec2 texCoords) {
-    vec3 dPosX = dFdx(worldPos);
-    vec3 dPosY = dFdy(worldPos);
-    vec2 dTexX = dFdx(texCoords);
-    vec2 dTexY = dFdy(texCoords);
-    
-    vec3 tangent = normalize(dPosX * dTexY.t - dPosY * dTexX.t);
-    vec3 bitangent = normalize(dPosY * dTexX.s - dPosX * dTexY.s);
+// Texture U runs along +X and V along +Z, so the tangent frame follows from the normal
+mat3 computeTBN(vec3 normal) {
+    vec3 tangent = normalize(vec3(1.0, 0.0, 0.0) - normal * normal.x);
+    vec3 bitangent = cross(tangent, normal);
     
     return mat3(tangent, bitangent, normal);
 }
 
+// Tangent-space normal from the map's RG; Z is rebuilt so two-channel BC5 maps work too
+vec3 sampleNormal(sampler2DArray map, vec3 uvw) {
+    vec2 xy = texture(map, uvw).rg * 2.0 - 1.0;
+    return vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+}
+
+void addBand(int band, float w, vec2 tiledCoords,
+             inout vec3 albedo, inout vec3 normalMap, inout float ao, inout float roughness) {
+    vec3 uvw = vec3(tiledCoords, float(bandLayers[band]));
+    albedo += texture(materialAlbedo, uvw).rgb * w;
+    normalMap += sampleNormal(materialNormal, uvw) * 0.5 * w;
+    vec3 orm = texture(materialORM, uvw).rgb;
+    ao += orm.r * w;
+    roughness += orm.g * w;
+}
+
 void main()
 {
-    vec3 dx = dFdx(WorldPos);
-    vec3 dy = dFdy(WorldPos);
-    vec3 geometricNormal = normalize(cross(dx, dy));
+    vec3 geometricNormal = normalize(Normal);
     
-    float blendRange = 8.0;
-    float wSand = 1.0 - smoothstep(sandHeight - blendRange, sandHeight + blendRange, Height);
-    float wGrass = smoothstep(sandHeight - blendRange, sandHeight + blendRange, Height) 
-                   * (1.0 - smoothstep(rockHeight - blendRange, rockHeight + blendRange, Height));
-    float wRock = smoothstep(rockHeight - blendRange, rockHeight + blendRange, Height) 
-                  * (1.0 - smoothstep(snowHeight - blendRange, snowHeight + blendRange, Height));
-    float wSnow = smoothstep(snowHeight - blendRange, snowHeight + blendRange, Height);
-    
-    float totalWeight = wSand + wGrass + wRock + wSnow;
-    if (totalWeight > 0.0) {
-        wSand /= totalWeight;
-        wGrass /= totalWeight;
-        wRock /= totalWeight;
-        wSnow /= totalWeight;
-    }
-
     vec2 tiledCoords = TexCoords * 6.0;
     
     vec3 albedo = vec3(0.0);
@@ -79,36 +59,23 @@ void main()
     float roughness = 0.0;
     float ao = 0.0;
     
-    if (wSand > 0.01) {
-        albedo += texture(sandAlbedo, tiledCoords).rgb * wSand;
-        blendedNormalMap += (texture(sandNormal, tiledCoords).rgb - vec3(0.5, 0.5, 0.5)) * wSand;
-        roughness += texture(sandRoughness, tiledCoords).r * wSand;
-        ao += texture(sandAO, tiledCoords).r * wSand;
-    }
-    if (wGrass > 0.01) {
-        albedo += texture(grassAlbedo, tiledCoords).rgb * wGrass;
-        blendedNormalMap += (texture(grassNormal, tiledCoords).rgb - vec3(0.5, 0.5, 0.5)) * wGrass;
-        roughness += texture(grassRoughness, tiledCoords).r * wGrass;
-        ao += texture(grassAO, tiledCoords).r * wGrass;
-    }
-    if (wRock > 0.01) {
-        albedo += texture(rockAlbedo, tiledCoords).rgb * wRock;
-        blendedNormalMap += (texture(rockNormal, tiledCoords).rgb - vec3(0.5, 0.5, 0.5)) * wRock;
-        roughness += texture(rockRoughness, tiledCoords).r * wRock;
-        ao += texture(rockAO, tiledCoords).r * wRock;
-    }
-    if (wSnow > 0.01) {
-        albedo += texture(snowAlbedo, tiledCoords).rgb * wSnow;
-        blendedNormalMap += (texture(snowNormal, tiledCoords).rgb - vec3(0.5, 0.5, 0.5)) * wSnow;
-        roughness += texture(snowRoughness, tiledCoords).r * wSnow;
-        ao += texture(snowAO, tiledCoords).r * wSnow;
-    }
-    
+#if (MATERIAL_LAYER_MASK & 1) != 0
+    addBand(0, MaterialWeights.x, tiledCoords, albedo, blendedNormalMap, ao, roughness);
+#endif
+#if (MATERIAL_LAYER_MASK & 2) != 0
+    addBand(1, MaterialWeights.y, tiledCoords, albedo, blendedNormalMap, ao, roughness);
+#endif
+#if (MATERIAL_LAYER_MASK & 4) != 0
+    addBand(2, MaterialWeights.z, tiledCoords, albedo, blendedNormalMap, ao, roughness);
+#endif
+#if (MATERIAL_LAYER_MASK & 8) != 0
+    addBand(3, MaterialWeights.w, tiledCoords, albedo, blendedNormalMap, ao, roughness);
+#endif
     
     roughness = clamp(roughness, 0.05, 0.95);
     ao = clamp(ao, 0.3, 1.0);
     
-    mat3 TBN = computeTBN(geometricNormal, WorldPos, TexCoords);
+    mat3 TBN = computeTBN(geometricNormal);
     vec3 tangentNormal = normalize(blendedNormalMap * 2.0 - 1.0);
     vec3 N = normalize(TBN * tangentNormal);
 
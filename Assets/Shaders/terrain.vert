@@ -1,23 +1,59 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTex;
+layout (location = 0) in float aHeight;   // unorm16 across the slot's height range
+layout (location = 1) in vec4 aWeights;   // sand, grass, rock, snow, baked on the CPU
+layout (location = 2) in vec2 aNormal;    // octahedral (x, z), see TerrainNormals.h
 
 out vec2 TexCoords;
 out vec3 WorldPos;
-out float Height;
+out vec4 MaterialWeights;
+out vec3 Normal;
 
-uniform mat4 model;
+// One texel per arena slot: chunk offset x, chunk offset z, heightBase, heightRange
+uniform samplerBuffer chunkSlots;
+uniform int slotVertices;     // vertices per slot; gl_VertexID includes the slot's base vertex
+uniform int gridSize;         // quads per chunk side
 uniform mat4 view;
 uniform mat4 projection;
 
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0) {
+        n.xz = (1.0 - abs(n.zx)) * sign(n.xz);
+    }
+    return normalize(n);
+}
+
+// Grid position of a vertex, in TerrainChunk::generateHeightmap's order: the
+// (gridSize + 1)^2 grid row by row, then the skirt ring north, south, west, east
+ivec2 gridCoords(int id) {
+    int rowLength = gridSize + 1;
+    if (id < rowLength * rowLength) {
+        return ivec2(id % rowLength, id / rowLength);
+    }
+
+    int skirt = id - rowLength * rowLength;
+    int side = skirt / rowLength;
+    int i = skirt % rowLength;
+    if (side < 2) {
+        return ivec2(i, side == 0 ? 0 : gridSize);
+    }
+    return ivec2(side == 2 ? 0 : gridSize, i);
+}
+
 void main()
 {
-    vec4 world = model * vec4(aPos, 1.0);
+    int slot = gl_VertexID / slotVertices;
+    vec4 slotData = texelFetch(chunkSlots, slot);
+
+    vec2 grid = vec2(gridCoords(gl_VertexID - slot * slotVertices));
+    vec4 world = vec4(grid.x + slotData.x, slotData.z + aHeight * slotData.w, grid.y + slotData.y, 1.0);
 
     WorldPos = world.xyz;
-    TexCoords = aTex;
-    Height = world.y;
+    // Texture coordinates (scale for more repetition)
+    TexCoords = grid / float(gridSize) * 2.0;
+    MaterialWeights = aWeights;
+    Normal = decodeOctahedral(aNormal);
 
     gl_Position = projection * view * world;
 }
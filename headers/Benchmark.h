@@ -0,0 +1,60 @@
+#pragma once
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct GLFWwindow;
+class Camera;
+class TerrainManager;
+
+// One recorded camera pose; the flythrough interpolates between these
+struct CameraKeyframe {
+    float time;         // seconds from the start of the path
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// Headless flythrough used by --benchmark. Drives the camera along a fixed path with a
+// fixed time step, so every run renders the same sequence of views, then writes a JSON report.
+class Benchmark {
+public:
+    explicit Benchmark(const std::string& reportPath, float frameStep = 1.0f / 60.0f);
+
+    // Creates a hidden window with an offscreen context: OSMesa on GLFW's null platform,
+    // falling back to EGL on the native platform. Calls glfwInit itself.
+    static GLFWwindow* createOffscreenWindow(int width, int height, const char* title);
+
+    bool isFinished() const { return frame >= frameCount; }
+    float getFrameStep() const { return frameStep; }
+
+    // Places the camera for the current frame and starts its timer
+    void beginFrame(Camera& camera);
+    // Waits for the GPU so the frame time includes rendering, then records stats
+    void endFrame(const TerrainManager& terrain);
+
+    bool writeReport(const TerrainManager& terrain) const;
+
+private:
+    CameraKeyframe samplePath(float time) const;
+
+    std::string reportPath;
+    float frameStep;
+    int frameCount;
+    int frame = 0;
+
+    std::vector<CameraKeyframe> path;
+    std::chrono::steady_clock::time_point frameStart;
+    std::chrono::steady_clock::time_point runStart;
+
+    std::vector<double> frameTimes;   // milliseconds
+    long long totalDrawCalls = 0;
+    long long totalTriangles = 0;
+    int maxDrawCalls = 0;
+};
+
+#endif // BENCHMARK_H
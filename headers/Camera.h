@@ -15,10 +15,15 @@ class Camera{
         static void staticMouseCallback(GLFWwindow* window,double xpos, double ypos);
         void updateViewMatrix();
 
+        // Places the camera directly, bypassing input (used by scripted playback)
+        void setPose(const glm::vec3& position, float yaw, float pitch);
+
         glm::mat4 getViewMatrix() const { return view; }
         glm::mat4 getProjectionMatrix() const { return projection; }
+        glm::mat4 getViewProjectionMatrix() const { return projection * view; }
         bool getWireframe() const { return wireframe; }
         glm::vec3 getCameraPos() const { return cameraPos; }
+        glm::vec3 getCameraFront() const { return cameraFront; }
 
 
     private:
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef DDSFILE_H
+#define DDSFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Block-compressed formats the renderer uploads directly
+enum DDSFormat {
+    DDSFormat_Unknown,
+    DDSFormat_BC1,  // RGB, 8 bytes per 4x4 block
+    DDSFormat_BC4,  // R, 8 bytes per block
+    DDSFormat_BC5   // RG, 16 bytes per block
+};
+
+struct DDSMipLevel {
+    int width;
+    int height;
+    size_t offset;  // into DDSImage::data
+    size_t size;
+};
+
+// A 2D texture with its full mip chain, rows stored bottom-up as OpenGL expects
+struct DDSImage {
+    DDSFormat format = DDSFormat_Unknown;
+    int width = 0;
+    int height = 0;
+    std::vector<DDSMipLevel> mips;
+    std::vector<unsigned char> data;
+};
+
+size_t getDDSBlockBytes(DDSFormat format);
+size_t getDDSLevelSize(DDSFormat format, int width, int height);
+const char* getDDSFormatName(DDSFormat format);
+
+// "dir/name.jpg" -> "dir/name.dds": baked textures live next to their source image
+std::string getDDSCachePath(const std::string& sourcePath);
+// True if the cache exists and is at least as new as the source (or the source is gone)
+bool isDDSCacheCurrent(const std::string& sourcePath, const std::string& cachePath);
+
+// Reads a DX10-header DDS (BC1/BC4/BC5 UNORM) or a legacy DXT1/ATI1/ATI2 FourCC file
+bool loadDDS(const std::string& path, DDSImage& image);
+// Always writes the DX10 extended header
+bool saveDDS(const std::string& path, const DDSImage& image);
+
+#endif // DDSFILE_H
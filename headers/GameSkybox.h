@@ -3,18 +3,23 @@
 #define GAMESKYBOX_H
 
 #include <glad/glad.h>
+#include "Shader.h"
+#include "ImageLoader.h"
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
 
-class Shader;
-
 class GameSkybox {
 public:
     GameSkybox();
     ~GameSkybox();
 
     bool loadCubemap(const std::vector<std::string>& faces);
+    // Queues the faces on loader; the skybox switches over once loader.finish() has uploaded all six.
+    // Returns false only if nothing could be queued; check isCubemapLoaded() after finish().
+    bool loadCubemap(ImageLoader& loader, const std::vector<std::string>& faces);
+    // False until a full set of faces has loaded; failed loads keep the previous cubemap
+    bool isCubemapLoaded() const { return cubemapLoaded; }
     void draw(const glm::mat4& view, const glm::mat4& projection);
 
     void setBrightness(float brightness) { this->brightness = brightness; }
@@ -24,10 +29,11 @@ private:
     GLuint skyboxVAO, skyboxVBO;
     GLuint cubemapTexture;
     Shader* skyboxShader;
+    UniformLocation viewUniform, projectionUniform, skyboxUniform, brightnessUniform;
     float brightness;
+    bool cubemapLoaded;
 
     void setupSkybox();
-    GLuint loadCubemapTextures(const std::vector<std::string>& faces);
     void createDefaultCubemap();
 };
 
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef HEIGHTMAPCACHE_H
+#define HEIGHTMAPCACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// On-disk cache of generated chunk heights, so a world already seen in an earlier
+// session (or evicted and revisited) loads with a page-in instead of noise evaluation.
+//
+// Chunks are grouped into region files of REGION_SIZE x REGION_SIZE chunks under
+// Cache/Heightmaps/<key>/, where the key hashes the seed, noise parameters and chunk
+// size. Changing any of them points the cache at a different directory, so stale
+// heights are never read back; only the most recently used MAX_DIRECTORIES keys are
+// kept on disk. Region files are fixed-size and memory-mapped: a header, one checksum
+// per chunk (zero while absent), then one slot of apronLength^2 floats per chunk. A
+// slot whose heights don't match its checksum, e.g. after a crash wrote back only
+// some of its pages, reads as a miss.
+//
+// At most MAX_MAPPED_REGIONS regions are mapped at once; the least recently used is
+// unmapped when another is needed. load and store are thread-safe; workers call them
+// directly.
+class HeightmapCache {
+public:
+    HeightmapCache(int seed, float noiseFreq, float noiseAmp, int chunkSize);
+    ~HeightmapCache();
+
+    HeightmapCache(const HeightmapCache&) = delete;
+    HeightmapCache& operator=(const HeightmapCache&) = delete;
+
+    // Whether this cache was created for these parameters
+    bool matches(int seed, float noiseFreq, float noiseAmp, int chunkSize) const;
+
+    // Copies a chunk's apronLength^2 heights into out; false if it isn't cached or fails
+    // its checksum, in which case out holds garbage
+    bool load(int chunkX, int chunkZ, float* out);
+    void store(int chunkX, int chunkZ, const float* heights);
+
+    int getApronLength() const { return apronLength; }
+
+    static const int REGION_SIZE = 32;
+    static const size_t MAX_MAPPED_REGIONS = 16;
+    static const int MAX_DIRECTORIES = 4;
+
+private:
+    class Region;
+
+    // Shared so a region evicted from the map stays mapped until its users are done
+    std::shared_ptr<Region> getRegion(int chunkX, int chunkZ);
+    // Marks this key's directory as used and deletes all but the newest MAX_DIRECTORIES
+    void removeStaleDirectories();
+
+    int seed;
+    float noiseFreq;
+    float noiseAmp;
+    int chunkSize;
+    int apronLength;  // chunkSize + 3: the vertex grid plus a one-vertex apron on each side
+    std::string directory;
+    bool directoryReady = false;
+
+    struct MappedRegion {
+        std::shared_ptr<Region> region;
+        unsigned long long lastUsed;
+    };
+    std::mutex regionMutex;
+    std::unordered_map<long long, MappedRegion> regions;
+    unsigned long long regionUses = 0;
+};
+
+#endif // HEIGHTMAPCACHE_H
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ThreadPool.h"
+
+// Pixels decoded by stb_image on a worker thread. pixels is null if the decode failed.
+struct DecodedImage {
+    std::string path;
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    double decodeMs = 0.0;
+};
+
+// Decodes image files on a thread pool and hands them back on the GL thread.
+// Queue every file with request(), then call finish(): it runs each callback on the
+// calling thread as soon as that file is decoded, so uploads overlap the remaining decodes.
+class ImageLoader {
+public:
+    using Callback = std::function<void(const DecodedImage&)>;
+
+    explicit ImageLoader(unsigned int threadCount = 0);
+    ~ImageLoader();
+
+    ImageLoader(const ImageLoader&) = delete;
+    ImageLoader& operator=(const ImageLoader&) = delete;
+
+    // The callback may upload to GL, and may request() further images, which the same
+    // finish() waits for; the pixels are freed once it returns
+    void request(const std::string& path, bool flipVertically, Callback onDecoded);
+
+    // Blocks until every requested image has been decoded and its callback has run
+    void finish();
+
+private:
+    struct Result {
+        DecodedImage image;
+        size_t requestIndex;
+    };
+
+    static void decode(DecodedImage& image, bool flipVertically);
+
+    std::vector<Callback> callbacks;
+    size_t delivered = 0;
+    std::chrono::steady_clock::time_point batchStart;
+
+    std::mutex resultMutex;
+    std::condition_variable resultReady;
+    std::vector<Result> results;
+
+    // Declared last so the workers are joined before the queues they fill
+    std::unique_ptr<ThreadPool> pool;
+};
+
+#endif // IMAGELOADER_H
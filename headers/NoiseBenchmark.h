@@ -0,0 +1,10 @@
+#pragma once
+#ifndef NOISEBENCHMARK_H
+#define NOISEBENCHMARK_H
+
+// Single-threaded throughput of every TerrainNoise backend on chunk-sized grids.
+// Prints samples per second per core and the error against FastNoiseLite.
+// Returns a process exit code (non-zero if a backend is out of tolerance).
+int runNoiseBenchmark();
+
+#endif // NOISEBENCHMARK_H
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef ORMPACKER_H
+#define ORMPACKER_H
+
+#include <string>
+#include <vector>
+
+// Per-layer AO, roughness and displacement packed into the R, G and B channels of one
+// texture, so the terrain shader needs one fetch and one sampler for all three.
+enum ORMChannel {
+    ORMChannel_AO,
+    ORMChannel_Roughness,
+    ORMChannel_Displacement,
+    ORMChannel_Count
+};
+
+// Single-channel 8-bit source map; empty pixels means the map is missing
+struct ORMSource {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// "<prefix>_AmbientOcclusion.jpg" etc.; the packed result is "<prefix>_ORM.dds"
+std::string getORMSourcePath(const std::string& prefix, ORMChannel channel);
+std::string getORMCachePath(const std::string& prefix);
+
+// Copies channel 0 of an interleaved image
+ORMSource makeORMSource(const unsigned char* pixels, int width, int height, int channels);
+
+// Interleaves the three maps into RGB8 at the size of the largest one (nearest sampling
+// for smaller maps). Missing maps become AO 1, roughness 0.5, displacement 0.
+// Returns false if every source is missing.
+bool packORM(const ORMSource sources[ORMChannel_Count], std::vector<unsigned char>& rgb, int& width, int& height);
+
+#endif // ORMPACKER_H
@@ -1,17 +1,62 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+// Pre-resolved uniform handle; setting an invalid one is a no-op, like location -1 in GL
+struct UniformLocation {
+    GLint location = -1;
+    bool isValid() const { return location >= 0; }
+};
+
 class Shader {
 public:
     unsigned int ID;
 
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // defines: extra source lines (e.g. "#define FOO 1\n") inserted after the #version line
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string& defines = "");
+    ~Shader();
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     void use();
-    void setMat4(const std::string& name, const float* value);
-    void setInt(const std::string& name, int value);
-    void setFloat(const std::string& name, float value);
-    void setVec3(const std::string& name, const glm::vec3& value);
 
+    // Looks up the table reflected at link time; no GL query and no allocation
+    UniformLocation getUniform(const char* name) const;
+
+    void setMat4(const char* name, const float* value);
+    void setInt(const char* name, int value);
+    void setFloat(const char* name, float value);
+    void setVec3(const char* name, const glm::vec3& value);
+
+    void setMat4(UniformLocation uniform, const float* value);
+    void setInt(UniformLocation uniform, int value);
+    void setFloat(UniformLocation uniform, float value);
+    void setVec3(UniformLocation uniform, const glm::vec3& value);
+    // Writes count consecutive elements starting at an array uniform's first element
+    void setIntArray(UniformLocation uniform, const int* values, int count);
+
+    // FNV-1a, usable at compile time for constant uniform names
+    static constexpr uint32_t hashName(const char* name) {
+        uint32_t hash = 2166136261u;
+        while (*name) {
+            hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+        }
+        return hash;
+    }
+
+private:
+    struct UniformEntry {
+        uint32_t hash;
+        GLint location;
+        std::string name;
+    };
+
+    void reflectUniforms();
+
+    // Sorted by hash
+    std::vector<UniformEntry> uniforms;
 };
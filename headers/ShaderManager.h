@@ -0,0 +1,28 @@
+#pragma once
+#ifndef SHADERMANAGER_H
+#define SHADERMANAGER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Shader.h"
+
+// Compiles each (vertex, fragment, defines) combination once and shares the program
+class ShaderManager {
+public:
+    static ShaderManager& getInstance();
+
+    // GL thread only
+    std::shared_ptr<Shader> getShader(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::string& defines = "");
+
+    // Drops the registry's references; call while the GL context is still current
+    void clear();
+
+private:
+    ShaderManager() = default;
+
+    std::unordered_map<std::string, std::shared_ptr<Shader>> shaders;
+};
+
+#endif // SHADERMANAGER_H
@@ -1,54 +1,121 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <glad/glad.h>
-#include "FastNoiseLite.h"
 #include <glm/glm.hpp>
 #include "Shader.h"
-#include "Camera.h"
+#include "TerrainIndexBuffer.h"
+#include "TerrainNoise.h"
 
 #ifndef TERRAINCHUNK_H
 #define TERRAINCHUNK_H
 
+// Interleaved vertex as uploaded: 12 bytes. X, Z and the texture coordinates are a
+// function of the vertex index, so terrain.vert rebuilds them from gl_VertexID.
+struct TerrainVertex {
+    int16_t normal[2];         // octahedral, snorm16 (see TerrainNormals.h)
+    unsigned char weights[4];  // sand, grass, rock, snow as normalized RGBA8, summing to 255
+    uint16_t height;           // unorm16 across the chunk's [heightBase, heightBase + heightRange]
+    uint16_t padding;          // keeps the stride a multiple of 4 bytes
+};
+
+
+// Inputs to the per-vertex material weights, captured when a chunk is requested.
+// Slope is 1 - normal.y: 0 on flat ground, 1 on a vertical face.
+struct TerrainMaterialRules {
+    float sandHeight = -20.0f;
+    float rockHeight = 30.0f;
+    float snowHeight = 45.0f;
+    float blendRange = 8.0f;
+
+    // Slopes past rockSlopeStart fade to rock, fully rock from rockSlopeEnd
+    float rockSlopeStart = 0.3f;
+    float rockSlopeEnd = 0.5f;
+};
+
+// CPU-side chunk data, produced on a worker thread and handed to the GL thread for upload
+struct ChunkMeshData {
+    int chunkX = 0;
+    int chunkZ = 0;
+    int size = 0;
+
+    std::vector<float> heights;
+    std::vector<TerrainVertex> vertices;
+
+    float minHeight = 0.0f;
+    float maxHeight = 0.0f;
+
+    // Dequantization of TerrainVertex::height
+    float heightBase = 0.0f;
+    float heightRange = 1.0f;
+
+    // Heights came from the on-disk cache rather than noise evaluation
+    bool fromCache = false;
+
+    // Bit per material band with a non-zero weight at any vertex (bit 0 = sand .. bit 3 = snow)
+    unsigned int layerMask = 0;
+
+    // Worker time spent in generateHeightmap, for profiling
+    double generationSeconds = 0.0;
+};
+
+class TerrainVertexArena;
+class HeightmapCache;
+struct TerrainDrawBatch;
+
 class TerrainChunk {
 public:
-    TerrainChunk(int chunkX, int chunkZ, int size, float noiseFreq, float noiseAmp);
+    // GL thread only: takes ownership of generated data and uploads it into an arena slot
+    TerrainChunk(ChunkMeshData&& data, TerrainVertexArena& arena);
     ~TerrainChunk();
 
-    void generateHeightmap();
-    void setupMesh();
-    void draw(Camera camera);
-    glm::mat4 getModelMatrix() const { return model; }
-    Shader& getShader() { return shader; }
+    TerrainChunk(const TerrainChunk&) = delete;
+    TerrainChunk& operator=(const TerrainChunk&) = delete;
+
+    // Thread-safe: touches no GL state. Heights come from heightmapCache when it has the
+    // chunk and are written back to it otherwise; pass nullptr to always evaluate noise.
+    static void generateHeightmap(ChunkMeshData& data, int noiseSeed, float noiseFreq, float noiseAmp,
+        TerrainNoise::Backend noiseBackend, const TerrainMaterialRules& materialRules,
+        HeightmapCache* heightmapCache);
+
+    // Queues this chunk into its arena's batch; TerrainManager issues the draw.
+    // Returns the number of triangles queued.
+    int addToBatch(TerrainDrawBatch& batch, int lodLevel) const;
+    TerrainVertexArena& getArena() const { return arena; }
+    int getLodCount() const;
+    glm::vec3 getOffset() const { return offset; }
+    // Bands whose weight is zero at every vertex stay zero across every fragment
+    unsigned int getLayerMask() const { return layerMask; }
+
+    int getChunkX() const { return chunkX; }
+    int getChunkZ() const { return chunkZ; }
+
+    // World-space bounds from the generated height range
+    glm::vec3 getBoundsMin() const { return glm::vec3(chunkX * size, minHeight, chunkZ * size); }
+    glm::vec3 getBoundsMax() const { return glm::vec3((chunkX + 1) * size, maxHeight, (chunkZ + 1) * size); }
+
+    // Memory held by this chunk, used by TerrainManager's eviction budget. The GPU side
+    // is its arena slot, which only returns to the driver when the arena shrinks.
+    size_t getGpuBytes() const { return gpuBytes; }
+    size_t getCpuBytes() const { return heights.capacity() * sizeof(float); }
 
 private:
     int chunkX, chunkZ;
     int size;
-    float noiseFreq;
-    float noiseAmp;
 
     unsigned int textureID;
 
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
+    TerrainVertexArena& arena;
+    int slot;
+    size_t gpuBytes = 0;
 
-    unsigned int VAO, VBO, EBO;
-    FastNoiseLite noise;
-
-    glm::mat4 model;
-
-    Shader shader;
+    glm::vec3 offset;
 
     std::vector<float> heights;
+    float minHeight, maxHeight;
+    unsigned int layerMask;
 
     void loadTexture();
-
-
-    float sandHeight = -20.0f;
-    float grassHeight = 10.0f;
-    float rockHeight = 30.0f;
-    float snowHeight = 45.0f;
-
-    
 };
 
 #endif // TERRAINCHUNK_H
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef TERRAINCHUNKGRID_H
+#define TERRAINCHUNKGRID_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "TerrainChunk.h"
+
+enum ChunkSlotState {
+    ChunkSlotState_Empty,
+    ChunkSlotState_Pending,   // queued, generating or waiting for upload
+    ChunkSlotState_Resident
+};
+
+// One grid cell: the chunk it currently holds and everything the frame loop reads about
+// it, so visibility and eviction only touch the chunk itself to queue its draw
+struct ChunkSlot {
+    int chunkX = 0;
+    int chunkZ = 0;
+    ChunkSlotState state = ChunkSlotState_Empty;
+    bool prefetched = false;  // requested by the prefetcher, not yet in the render square
+
+    // Copied from the chunk on upload
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    unsigned int layerMask = 0;
+    int lodCount = 0;
+    unsigned long long lastDrawnFrame = 0;
+
+    TerrainChunk* chunk = nullptr;
+
+    bool holds(int cx, int cz) const {
+        return state != ChunkSlotState_Empty && chunkX == cx && chunkZ == cz;
+    }
+};
+
+// Toroidal 2D array of chunk slots: chunk (x, z) always lives in slot
+// (x mod dimension, z mod dimension), so lookups are two wraps and an index, and a
+// slot is recycled when the camera moves far enough for a new chunk to map onto it.
+// The dimension must exceed twice the farthest distance a live chunk can be from the
+// camera, so two chunks that are both still needed never share a slot.
+class TerrainChunkGrid {
+public:
+    explicit TerrainChunkGrid(int dimension = 1);
+
+    // Drops every slot; the caller must have released the chunks they held
+    void reset(int dimension);
+
+    int getDimension() const { return dimension; }
+
+    ChunkSlot& at(int cx, int cz) { return slots[wrap(cz) * dimension + wrap(cx)]; }
+    const ChunkSlot& at(int cx, int cz) const { return slots[wrap(cz) * dimension + wrap(cx)]; }
+
+    std::vector<ChunkSlot>& getSlots() { return slots; }
+    const std::vector<ChunkSlot>& getSlots() const { return slots; }
+
+private:
+    int wrap(int value) const {
+        int wrapped = value % dimension;
+        return wrapped < 0 ? wrapped + dimension : wrapped;
+    }
+
+    int dimension;
+    std::vector<ChunkSlot> slots;
+};
+
+#endif // TERRAINCHUNKGRID_H
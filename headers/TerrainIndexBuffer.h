@@ -0,0 +1,58 @@
+#pragma once
+#ifndef TERRAININDEXBUFFER_H
+#define TERRAININDEXBUFFER_H
+
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+#include "TerrainTopology.h"
+
+// Element buffer shared by every chunk of one resolution: all chunks with the same
+// size have identical grid topology, so the indices are built and uploaded once.
+//
+// The buffer holds one index range per level of detail. Level n samples every
+// 2^n-th grid vertex and closes the chunk edges with skirts hanging from the
+// border vertices, which hide cracks against neighbours at a different level.
+class TerrainIndexBuffer {
+public:
+    struct LodRange {
+        int stride;
+        GLsizei indexCount;
+        size_t byteOffset;
+    };
+
+    // GL thread only
+    explicit TerrainIndexBuffer(int size);
+    ~TerrainIndexBuffer();
+
+    TerrainIndexBuffer(const TerrainIndexBuffer&) = delete;
+    TerrainIndexBuffer& operator=(const TerrainIndexBuffer&) = delete;
+
+    // Binds to GL_ELEMENT_ARRAY_BUFFER, which also attaches it to the bound VAO
+    void bind() const;
+
+    // Grid vertices come first, followed by the skirt ring (see TerrainChunk::generateHeightmap)
+    static int getGridVertexCount(int size) { return getTerrainGridVertexCount(size); }
+    static int getVertexCount(int size) { return getTerrainVertexCount(size); }
+
+    int getSize() const { return size; }
+    int getLodCount() const { return static_cast<int>(lods.size()); }
+    const LodRange& getLod(int level) const { return lods[level]; }
+    // GL_UNSIGNED_SHORT whenever the grid fits, GL_UNSIGNED_INT otherwise
+    GLenum getIndexType() const { return indexType; }
+    size_t getBytes() const { return bytes; }
+
+    static const int MAX_LOD_LEVELS = 4;
+
+private:
+    template <typename IndexT>
+    void upload(int size);
+
+    int size;
+    GLuint EBO = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    size_t bytes = 0;
+    std::vector<LodRange> lods;
+};
+
+#endif // TERRAININDEXBUFFER_H
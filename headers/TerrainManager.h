@@ -1,17 +1,28 @@
-
 #pragma once
 #ifndef TERRAINMANAGER_H
 #define TERRAINMANAGER_H
 
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include "TerrainChunk.h"
+#include "TerrainChunkGrid.h"
+#include "HeightmapCache.h"
+#include "TerrainIndexBuffer.h"
+#include "TerrainVertexArena.h"
 #include "Shader.h"
 #include "Camera.h"
+#include "Frustum.h"
+#include "ThreadPool.h"
+#include "TerrainNoise.h"
 
 class TerrainManager {
 public:
-    std::unordered_map<long long, TerrainChunk*> chunks;
+    TerrainManager();
+    ~TerrainManager();
 
     int chunkSize = 32;
     int renderDistance = 6; // number of chunks
@@ -19,13 +30,225 @@ public:
 // In TerrainManager.h
     float noiseFreq = 0.7f; // Slightly higher freq to ensure we see features
     float noiseAmp = 8.0f;   // Total range approx -60 to +60 due to the 1.2x bias
+    int noiseSeed = 1337;
+
+    // Reuse heights from earlier sessions (see HeightmapCache); keyed by the noise
+    // settings above, so changing them simply starts a new cache
+    bool useHeightmapCache = true;
+
+    // Live chunk memory (occupied arena slots, shared index buffers and retained CPU
+    // heights). Least recently drawn chunks beyond evictionDistance are freed once usage
+    // exceeds the budget. Arenas never shrink below room for the visible square, so a
+    // budget under getMinimumMemoryBudget() is treated as that minimum.
+    size_t memoryBudget = 64 * 1024 * 1024;
+    int evictionDistance = 8; // number of chunks, kept larger than renderDistance
+
+    // Chunks closer than lodDistance draw at full resolution; each doubling of the
+    // distance halves the grid resolution, up to TerrainIndexBuffer::MAX_LOD_LEVELS
+    float lodDistance = 48.0f;
+
+    // Material band heights and slope rule, baked into each chunk's vertex weights when
+    // it is generated; changes only reach chunks requested afterwards
+    TerrainMaterialRules materialRules;
+
+    // Main-thread time per frame for chunk buffer uploads and destruction of evicted
+    // chunks. At least one item runs each frame; the rest waits for later frames.
+    float mainThreadBudgetMs = 2.0f;
+
+    // Chunks around the camera's position this many seconds ahead (extrapolated from its
+    // recent velocity) are queued before they enter the render square, at a boosted
+    // build priority. 0 disables prefetching.
+    float prefetchSeconds = 1.5f;
 
   
-    void update(Camera camera);
+    void update(const Camera& camera, float deltaTime);
+
+    // Frees every chunk and shared GPU resource; call while the GL context is still current
+    void releaseChunks();
+
+    size_t getResidentChunkCount() const { return residentChunks; }
+    size_t getPendingChunkCount() const { return chunkRequests.size() + chunksInFlight + uploadQueue.size(); }
+    // Pending chunks split into those still in the build queue and those on a worker
+    size_t getQueuedChunkCount() const { return chunkRequests.size(); }
+    size_t getInFlightChunkCount() const { return chunksInFlight; }
+    // Queued requests dropped because the camera moved away before they were built
+    size_t getCancelledChunkCount() const { return cancelledChunks; }
+    // Main-thread work carried over to later frames, and last frame's time spent on it
+    size_t getUploadBacklog() const { return uploadQueue.size(); }
+    size_t getDestroyBacklog() const { return destroyQueue.size(); }
+    double getMainThreadWorkTime() const { return mainThreadWorkSeconds; }
+    size_t getGpuMemoryUsage() const { return gpuMemoryUsage; }
+    size_t getCpuMemoryUsage() const { return cpuMemoryUsage; }
+    size_t getMemoryUsage() const { return gpuMemoryUsage + cpuMemoryUsage; }
+    size_t getPeakMemoryUsage() const { return peakMemoryUsage; }
+    // What the arenas have reserved on the GPU, free slots included, plus CPU heights
+    size_t getAllocatedMemoryUsage() const { return allocatedGpuMemory + cpuMemoryUsage; }
+    size_t getPeakAllocatedMemoryUsage() const { return peakAllocatedMemory; }
+    // The arenas' footprint at their initial size, which shrinking never goes below
+    size_t getMinimumMemoryBudget() const;
+    size_t getEvictedChunkCount() const { return evictedChunks; }
+
+    // Last frame's frustum culling result
+    int getDrawnChunkCount() const { return drawnChunks; }
+    int getCulledChunkCount() const { return culledChunks; }
+    int getDrawnTriangleCount() const { return drawnTriangles; }
+    int getDrawCallCount() const { return drawCalls; }
+    // Distinct layer-mask shader permutations bound last frame
+    int getProgramBindCount() const { return programBinds; }
+
+    // Chunks generated since startup and the worker time they took
+    size_t getGeneratedChunkCount() const { return generatedChunks; }
+    double getChunkGenerationTime() const { return chunkGenerationSeconds; }
+    double getMaxChunkGenerationTime() const { return maxChunkGenerationSeconds; }
+    // How many of those were read from the heightmap cache instead of generated
+    size_t getCachedChunkCount() const { return cachedChunks; }
+
+    // Prefetched chunks that were already resident when they entered the render square,
+    // that were still generating, and that were evicted without ever entering it
+    size_t getPrefetchRequestCount() const { return prefetchRequests; }
+    size_t getPrefetchHitCount() const { return prefetchHits; }
+    size_t getPrefetchLateCount() const { return prefetchLate; }
+    size_t getPrefetchWastedCount() const { return prefetchWasted; }
+    float getPrefetchHitRate() const {
+        size_t used = prefetchHits + prefetchLate;
+        return used ? static_cast<float>(prefetchHits) / used : 0.0f;
+    }
+
+private:
+    // Binds the material textures once for all chunk draws this frame
+    void beginTerrainPass();
+    void endTerrainPass();
+    void setupTerrainShaders();
+    // Binds one permutation and sets its per-frame lights and camera
+    void bindTerrainProgram(unsigned int layerMask, const Camera& camera);
+
+    // Adds the chunk to the build queue unless it is already queued or generating
+    bool queueChunk(int cx, int cz, bool prefetch);
+    // Re-scores the build queue, cancels stale requests and hands the best ones to workers
+    void scheduleChunkRequests(const Camera& camera, const Frustum& frustum, int camChunkX, int camChunkZ);
+    void requestChunk(int cx, int cz);
+    void updateCameraVelocity(const glm::vec3& cameraPos, float deltaTime);
+    void prefetchChunks(int camChunkX, int camChunkZ);
+    // Moves finished worker output into the upload queue
+    void collectCompletedChunks();
+    // Destroys evicted chunks, then uploads finished ones, until the frame budget is spent
+    void processMainThreadWork();
+    void uploadChunk(ChunkMeshData& data);
+    void evictChunks(int camChunkX, int camChunkZ);
+    void destroyChunk(TerrainChunk* chunk);
+    // Empties a resident slot and queues its chunk for destruction
+    void retireChunk(ChunkSlot& slot);
+    int getRequiredGridDimension() const;
+    int selectLod(const ChunkSlot& slot, const glm::vec3& cameraPos) const;
+    TerrainVertexArena& getArena(int size);
+    // Recounts arena capacity after it changes, and updates the peaks
+    void updateAllocatedMemory();
+
+    unsigned long long frameIndex = 0;
+
+    // Checks the batched kernel against FastNoiseLite at the current seed and frequency
+    void selectNoiseBackend();
+
+    // Picked before the first request, and again whenever noiseSeed or noiseFreq change
+    TerrainNoise::Backend noiseBackend = TerrainNoise::Backend_Reference;
+    bool hasNoiseBackend = false;
+    int checkedNoiseSeed = 0;
+    float checkedNoiseFreq = 0.0f;
+
+    size_t gpuMemoryUsage = 0;
+    size_t cpuMemoryUsage = 0;
+    size_t peakMemoryUsage = 0;
+    size_t allocatedGpuMemory = 0;
+    size_t peakAllocatedMemory = 0;
+    size_t evictedChunks = 0;
+
+    int drawnChunks = 0;
+    int culledChunks = 0;
+    int drawnTriangles = 0;
+    int drawCalls = 0;
+    int programBinds = 0;
+
+    size_t generatedChunks = 0;
+    double chunkGenerationSeconds = 0.0;
+    double maxChunkGenerationSeconds = 0.0;
+    size_t cachedChunks = 0;
+
+    // Smoothed camera velocity, measured from its movement between updates
+    glm::vec3 lastCameraPos = glm::vec3(0.0f);
+    glm::vec3 cameraVelocity = glm::vec3(0.0f);
+    bool hasLastCameraPos = false;
+
+    // How far past the render square this frame's prefetch path reached, in chunks
+    int prefetchReach = 0;
+    size_t prefetchRequests = 0;
+    size_t prefetchHits = 0;
+    size_t prefetchLate = 0;
+    size_t prefetchWasted = 0;
+
+    // Shared with in-flight jobs, which keep an outdated cache alive until they finish
+    std::shared_ptr<HeightmapCache> heightmapCache;
+
+    // One vertex arena (and shared element buffer) per chunk resolution
+    std::unordered_map<int, std::unique_ptr<TerrainVertexArena>> arenas;
+
+    // Resolved once from TextureManager: albedo, normal and packed ORM texture arrays,
+    // shared by the four height bands through per-band layer indices
+    static const int MATERIAL_BANDS = 4;
+    static const int MATERIAL_MAPS = 3;
+    static const int MATERIAL_PERMUTATIONS = 1 << MATERIAL_BANDS;
+
+    // Resolved once per program so the frame loop never queries locations
+    struct TerrainUniforms {
+        UniformLocation projection, view, viewPos;
+        UniformLocation lightPos, lightColor;
+        TerrainArenaUniforms arena;
+    };
+
+    // terrain.frag compiled with MATERIAL_LAYER_MASK set to the index, so a chunk only
+    // samples the bands it contains. Index 0 is unused: every vertex has some weight.
+    struct TerrainProgram {
+        std::shared_ptr<Shader> shader;
+        TerrainUniforms uniforms;
+    };
+    TerrainProgram terrainPrograms[MATERIAL_PERMUTATIONS];
+
+    // Visible chunks and their LOD, bucketed by layer mask; reused every frame
+    std::vector<std::pair<ChunkSlot*, int>> drawLists[MATERIAL_PERMUTATIONS];
+    TerrainDrawBatch drawBatch;
+
+    // Texture arrays from TextureManager, or its stand-ins if the sets didn't load
+    unsigned int materialTextures[MATERIAL_MAPS] = {};
+
+    // Every chunk that is resident or pending, by position (GL thread only). Sized from
+    // renderDistance and evictionDistance on the first update.
+    TerrainChunkGrid grid;
+    size_t residentChunks = 0;
+
+    // Requests not yet handed to a worker. Only a few jobs are in the pool at a time,
+    // so the order can still change as the camera turns.
+    struct ChunkRequest {
+        int chunkX;
+        int chunkZ;
+        bool prefetch;
+        float priority; // lower builds sooner
+    };
+    std::vector<ChunkRequest> chunkRequests;
+    size_t chunksInFlight = 0;
+    size_t cancelledChunks = 0;
 
-    long long hash(int x, int z);
+    // Finished CPU-side data waiting for upload, filled by the workers
+    std::mutex completedMutex;
+    std::vector<ChunkMeshData> completedChunks;
 
+    // Main-thread work waiting for budget. Evicted chunks are already out of the chunk
+    // map; retiringMemory is what they still hold, so eviction doesn't overshoot.
+    std::deque<ChunkMeshData> uploadQueue;
+    std::vector<TerrainChunk*> destroyQueue;
+    size_t retiringMemory = 0;
+    double mainThreadWorkSeconds = 0.0;
 
+    // Declared last so the workers are joined before anything they touch is destroyed
+    std::unique_ptr<ThreadPool> workerPool;
 };
 
 #endif // TERRAINMANAGER_H
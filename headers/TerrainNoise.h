@@ -0,0 +1,45 @@
+#pragma once
+#ifndef TERRAINNOISE_H
+#define TERRAINNOISE_H
+
+// Batched 2D Perlin noise that reproduces FastNoiseLite's Perlin path (no fractal,
+// no domain rotation) for whole rows of samples at once, using AVX2 or SSE4.1 when
+// the CPU has them and a scalar loop otherwise. Backend_Reference calls
+// FastNoiseLite per sample and is kept as the ground truth and safe fallback.
+class TerrainNoise {
+public:
+    enum Backend {
+        Backend_Reference,
+        Backend_Scalar,
+        Backend_SSE41,
+        Backend_AVX2
+    };
+
+    // Defaults match a default-constructed FastNoiseLite
+    explicit TerrainNoise(int seed = 1337, float frequency = 0.01f);
+
+    // Fills out[z * width + x] with the noise at world integer coordinates
+    // (startX + x, startZ + z), pre-scaled by coordScale exactly like
+    // FastNoiseLite::GetNoise((startX + x) * coordScale, (startZ + z) * coordScale).
+    void evaluateGrid(int startX, int startZ, int width, int height, float coordScale, float* out) const;
+
+    Backend getBackend() const { return backend; }
+    // Clamped to what the CPU supports
+    void setBackend(Backend requested);
+
+    static Backend getBestBackend();
+    static const char* getBackendName(Backend backend);
+
+    // Largest absolute difference against FastNoiseLite over a spread of sample points,
+    // at the coordScale the caller will pass to evaluateGrid
+    float measureMaxError(float coordScale, int sampleCount = 4096) const;
+
+private:
+    void evaluateRow(float y, int startX, int count, float coordScale, float* out) const;
+
+    int seed;
+    float frequency;
+    Backend backend;
+};
+
+#endif // TERRAINNOISE_H
@@ -0,0 +1,19 @@
+#pragma once
+#ifndef TERRAINNORMALS_H
+#define TERRAINNORMALS_H
+
+#include <cstdint>
+
+// Heightfield normals packed as two snorm16 octahedral coordinates (x, z); y is always
+// up for a heightfield, so the lower-hemisphere fold never triggers on encode.
+// The vertex shader unpacks them with decodeOctahedral in terrain.vert.
+
+// Encodes count normals for one grid row from central differences with unit spacing.
+// row[-1] and row[count] must be readable (the one-vertex apron); above and below are
+// the neighbouring rows (z - 1 and z + 1). Writes 2 * count values to out.
+void encodeNormalRow(const float* above, const float* row, const float* below, int count, int16_t* out);
+
+// Scalar version of the same kernel, kept as the reference for the SSE2 path
+void encodeNormalRowScalar(const float* above, const float* row, const float* below, int count, int16_t* out);
+
+#endif // TERRAINNORMALS_H
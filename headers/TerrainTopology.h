@@ -0,0 +1,30 @@
+#pragma once
+#ifndef TERRAINTOPOLOGY_H
+#define TERRAINTOPOLOGY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GL-free index generation behind TerrainIndexBuffer, shared with the offline tools.
+//
+// A chunk of size n has (n + 1)^2 grid vertices followed by a skirt ring of 4 * (n + 1)
+// (see TerrainChunk::generateHeightmap). Level l samples every 2^l-th grid vertex and
+// closes the edges with skirt quads.
+
+struct TerrainLodIndices {
+    int stride;
+    size_t firstIndex;
+    size_t indexCount;
+};
+
+inline int getTerrainGridVertexCount(int size) { return (size + 1) * (size + 1); }
+inline int getTerrainVertexCount(int size) { return getTerrainGridVertexCount(size) + 4 * (size + 1); }
+
+// Appends every level's triangle list (row-major quads, then skirts) and records its
+// range. With optimizeForCache, each level's triangles are reordered for the
+// post-transform vertex cache; the set of triangles and their winding don't change.
+std::vector<uint32_t> buildTerrainIndices(int size, int maxLevels, bool optimizeForCache,
+    std::vector<TerrainLodIndices>& lods);
+
+#endif // TERRAINTOPOLOGY_H
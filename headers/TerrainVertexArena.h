@@ -0,0 +1,93 @@
+#pragma once
+#ifndef TERRAINVERTEXARENA_H
+#define TERRAINVERTEXARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "TerrainChunk.h"
+#include "TerrainIndexBuffer.h"
+
+// Draws gathered for one glMultiDrawElementsBaseVertex call; reused across frames
+struct TerrainDrawBatch {
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    std::vector<GLint> baseVertices;
+
+    void clear() { counts.clear(); offsets.clear(); baseVertices.clear(); }
+    bool empty() const { return counts.empty(); }
+};
+
+// Per-program uniforms the arena sets before drawing
+struct TerrainArenaUniforms {
+    UniformLocation gridSize;
+    UniformLocation slotVertices;
+};
+
+// Geometry for every chunk of one size: one VAO over one vertex buffer split into
+// fixed-size slots, plus the index buffer they share. A texture buffer holds each
+// slot's chunk offset and height dequantization, which terrain.vert fetches from
+// gl_VertexID / slotVertices, so a batch of chunks needs no per-chunk state and
+// draws with a single call. Slots are recycled through a free list, and the arena
+// doubles (copying on the GPU) when it runs out. shrinkToFit() halves it again once
+// occupancy drops, moving live slots down and updating their owners.
+class TerrainVertexArena {
+public:
+    // GL thread only
+    TerrainVertexArena(int size, int initialSlots = 64);
+    ~TerrainVertexArena();
+
+    TerrainVertexArena(const TerrainVertexArena&) = delete;
+    TerrainVertexArena& operator=(const TerrainVertexArena&) = delete;
+
+    // Copies a chunk's vertices into a free slot and stores it in slotRef, which must stay
+    // valid until release(); shrinkToFit() rewrites it if the slot moves
+    void allocate(int& slotRef, const std::vector<TerrainVertex>& vertices, const glm::vec3& offset,
+        float heightBase, float heightRange);
+    void release(int slot);
+
+    // Halves the arena while at most a quarter of it is in use, never below its initial
+    // size. Returns true if it shrank.
+    bool shrinkToFit();
+
+    // Queues one slot at one LOD; returns its triangle count
+    int addDraw(TerrainDrawBatch& batch, int slot, int lodLevel) const;
+    // Expects the terrain program to be bound; the slot table goes on SLOT_TEXTURE_UNIT
+    void draw(Shader& shader, const TerrainArenaUniforms& uniforms, const TerrainDrawBatch& batch) const;
+
+    static const int SLOT_TEXTURE_UNIT = 3;
+
+    const TerrainIndexBuffer& getIndexBuffer() const { return *indexBuffer; }
+    int getSize() const { return indexBuffer->getSize(); }
+    int getSlotVertices() const { return slotVertices; }
+    size_t getSlotBytes() const { return slotVertices * sizeof(TerrainVertex); }
+    // One slot's vertices plus its slot-table entry
+    size_t getSlotFootprint() const { return getSlotBytes() + sizeof(glm::vec4); }
+    // Vertex and slot-table storage reserved on the GPU, used or not
+    size_t getCapacityBytes() const { return capacity * getSlotFootprint(); }
+    size_t getMinCapacityBytes() const { return minCapacity * getSlotFootprint(); }
+
+private:
+    // Reallocates both buffers; live slots past a smaller capacity move into free ones
+    void resize(int newCapacity);
+    void setupVertexArray();
+
+    std::unique_ptr<TerrainIndexBuffer> indexBuffer;
+    int slotVertices;
+    int capacity = 0;
+    int minCapacity;
+    int liveSlots = 0;
+    std::vector<int> freeSlots;
+    // Each live slot's slotRef, null for free slots
+    std::vector<int*> slotOwners;
+
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint slotBuffer = 0;
+    GLuint slotTexture = 0;
+};
+
+#endif // TERRAINVERTEXARENA_H
@@ -2,6 +2,9 @@
 #include <glad/glad.h>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ImageLoader.h"
 
 class TextureManager {
 public:
@@ -13,8 +16,23 @@ public:
 
     // PBR texture set loading
     void loadPBRTextureSet(const std::string& name, const std::string& basePath);
+    // Queues the set's decodes on loader; the set is available once loader.finish() returns
+    void loadPBRTextureSet(ImageLoader& loader, const std::string& name, const std::string& basePath);
     bool hasPBRTextureSet(const std::string& name);
     void bindPBRTextures(const std::string& name, GLuint startUnit = 0);
+    // type is "albedo", "normal" or "orm" (AO, roughness, displacement in RGB); 0 if missing
+    unsigned int getPBRTexture(const std::string& name, const std::string& type);
+
+    // Copies the named sets into one GL_TEXTURE_2D_ARRAY per map type, a layer per set in
+    // the given order, then frees the sets' individual 2D textures. Missing maps get a
+    // neutral stand-in layer (1x1 if no set has that map type); fails only without sets.
+    bool buildPBRTextureArrays(const std::vector<std::string>& setNames);
+    // type is "albedo", "normal" or "orm"; 0 until buildPBRTextureArrays succeeds
+    unsigned int getPBRTextureArray(const std::string& type);
+    // One-layer 1x1 array of the stand-in colour, for drawing before or without the sets
+    unsigned int getPBRStandInArray(const std::string& type);
+    // Array layer holding the set, or -1
+    int getPBRArrayLayer(const std::string& name);
 
 private:
     TextureManager() = default;
@@ -25,7 +43,25 @@ private:
     // PBR texture sets: name -> {type -> textureID}
     std::unordered_map<std::string, std::unordered_map<std::string, unsigned int>> pbrTextures;
 
+    // PBR texture arrays: type -> array textureID, plus the set stored in each layer
+    std::unordered_map<std::string, unsigned int> pbrArrays;
+    std::vector<std::string> pbrArrayLayers;
+    std::unordered_map<std::string, unsigned int> pbrStandIns;
+
     unsigned int loadTextureFromFile(const std::string& path);
+    // GL thread only: uploads decoded pixels with mipmaps; 0 if the decode failed
+    unsigned int createTexture(const DecodedImage& image);
+    // Loads the baked .dds next to sourcePath if it is current; 0 means use the source image
+    unsigned int loadCompressedTexture(const std::string& sourcePath);
+    unsigned int loadDDSTexture(const std::string& cachePath);
+    // Loads <prefix>_ORM.dds if it is newer than all three source maps
+    unsigned int loadPackedORM(const std::string& prefix);
+    void reportPBRTextureSet(const std::string& name);
+    // fill is the RGBA used for layers whose source is 0
+    unsigned int buildTextureArray(const std::vector<unsigned int>& sources, const unsigned char fill[4]);
+
+    // File name prefix of each known set, e.g. "Rock020_2K-JPG"
+    static std::string getPBRFilePrefix(const std::string& name);
 
 
 
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef VERTEXCACHE_H
+#define VERTEXCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Post-transform vertex cache efficiency of a triangle list
+struct VertexCacheStats {
+    double acmr = 0.0;  // cache misses per triangle: 0.5 is ideal for a large grid, 3 the worst
+    double atvr = 0.0;  // cache misses per referenced vertex: 1 means each vertex is shaded once
+};
+
+// Simulates a FIFO cache of cacheSize entries over the list
+VertexCacheStats measureVertexCache(const uint32_t* indices, size_t indexCount, int vertexCount, int cacheSize = 16);
+
+// Reorders the triangles in place with Tom Forsyth's linear-speed vertex cache
+// optimisation: greedily emits the triangle whose vertices score highest, favouring
+// vertices still in a simulated LRU cache and vertices with few triangles left.
+// Vertex order is untouched.
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, int vertexCount);
+
+#endif // VERTEXCACHE_H
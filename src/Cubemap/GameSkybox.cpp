@@ -1,13 +1,17 @@
 #include "GameSkybox.h"
 #include "Shader.h"
 #include <iostream>
+#include <memory>
 #include <vector>
-#include "stb_image.h"
 #include <glm/gtc/type_ptr.hpp>
 
-GameSkybox::GameSkybox() : brightness(1.0f), skyboxShader(nullptr) {
+GameSkybox::GameSkybox() : skyboxShader(nullptr), brightness(1.0f), cubemapLoaded(false) {
     // Create shader first
     skyboxShader = new Shader("Assets/Shaders/skybox.vert", "Assets/Shaders/skybox.frag");
+    viewUniform = skyboxShader->getUniform("view");
+    projectionUniform = skyboxShader->getUniform("projection");
+    skyboxUniform = skyboxShader->getUniform("skybox");
+    brightnessUniform = skyboxShader->getUniform("brightness");
     setupSkybox();
     createDefaultCubemap(); // Create a simple blue sky as fallback
 }
@@ -83,67 +87,6 @@ void GameSkybox::setupSkybox() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-GLuint GameSkybox::loadCubemapTextures(const std::vector<std::string>& faces) {
-    if (faces.size() != 6) {
-        std::cout << "ERROR: Need exactly 6 faces for cubemap. Got " << faces.size() << std::endl;
-        return 0;
-    }
-
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-    int width, height, nrChannels;
-
-    // IMPORTANT: Cubemaps should NOT be flipped vertically
-    stbi_set_flip_vertically_on_load(false);
-
-    for (unsigned int i = 0; i < 6; i++) {
-        std::cout << "Loading cubemap face: " << faces[i] << std::endl;
-
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
-            GLenum format = GL_RGB;
-            if (nrChannels == 1) {
-                format = GL_RED;
-            }
-            else if (nrChannels == 3) {
-                format = GL_RGB;
-            }
-            else if (nrChannels == 4) {
-                format = GL_RGBA;
-            }
-
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format,
-                width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
-
-            std::cout << "  Success! " << width << "x" << height << " channels: " << nrChannels << std::endl;
-        }
-        else {
-            std::cout << "  FAILED to load cubemap face: " << faces[i] << std::endl;
-            stbi_image_free(data);
-
-            // Load a colorful error texture
-            unsigned char errorColor[3] = { 255, 0, 255 }; // Magenta
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB,
-                1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, errorColor);
-        }
-    }
-
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-    // Restore flip setting
-    stbi_set_flip_vertically_on_load(true);
-
-    return textureID;
-}
-
 void GameSkybox::createDefaultCubemap() {
     // Create a simple gradient blue sky as fallback
     glGenTextures(1, &cubemapTexture);
@@ -173,20 +116,88 @@ void GameSkybox::createDefaultCubemap() {
 }
 
 bool GameSkybox::loadCubemap(const std::vector<std::string>& faces) {
-    GLuint newTexture = loadCubemapTextures(faces);
-
-    if (newTexture != 0) {
-        // Delete old texture if it exists
-        if (cubemapTexture != 0) {
-            glDeleteTextures(1, &cubemapTexture);
-        }
-        cubemapTexture = newTexture;
-        std::cout << "Skybox loaded successfully!" << std::endl;
-        return true;
+    ImageLoader loader;
+    if (!loadCubemap(loader, faces)) return false;
+    loader.finish();
+    return cubemapLoaded;
+}
+
+bool GameSkybox::loadCubemap(ImageLoader& loader, const std::vector<std::string>& faces) {
+    if (faces.size() != 6) {
+        std::cout << "ERROR: Need exactly 6 faces for cubemap. Got " << faces.size() << std::endl;
+        std::cout << "Failed to load skybox, using default" << std::endl;
+        return false;
+    }
+
+    GLuint newTexture;
+    glGenTextures(1, &newTexture);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, newTexture);
+
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    // Faces upload in whatever order they finish decoding
+    struct LoadState {
+        int remaining = 6;
+        bool failed = false;
+    };
+    auto state = std::make_shared<LoadState>();
+    cubemapLoaded = false;
+
+    for (unsigned int i = 0; i < 6; i++) {
+        std::cout << "Loading cubemap face: " << faces[i] << std::endl;
+
+        // IMPORTANT: Cubemaps should NOT be flipped vertically
+        loader.request(faces[i], false, [this, newTexture, i, state](const DecodedImage& image) {
+            glBindTexture(GL_TEXTURE_CUBE_MAP, newTexture);
+
+            if (image.pixels) {
+                GLenum format = GL_RGB;
+                if (image.channels == 1) {
+                    format = GL_RED;
+                }
+                else if (image.channels == 3) {
+                    format = GL_RGB;
+                }
+                else if (image.channels == 4) {
+                    format = GL_RGBA;
+                }
+
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format,
+                    image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+
+                std::cout << "  Success! " << image.width << "x" << image.height << " channels: " << image.channels << std::endl;
+            }
+            else {
+                std::cout << "  FAILED to load cubemap face: " << image.path << std::endl;
+                state->failed = true;
+            }
+
+            if (--state->remaining > 0) return;
+
+            // A partial cubemap is worse than none: keep the current one (the default
+            // gradient unless an earlier load succeeded)
+            if (state->failed) {
+                glDeleteTextures(1, &newTexture);
+                std::cout << "Failed to load skybox, using default" << std::endl;
+                return;
+            }
+
+            // Swap in the new cubemap once every face is present
+            if (cubemapTexture != 0) {
+                glDeleteTextures(1, &cubemapTexture);
+            }
+            cubemapTexture = newTexture;
+            cubemapLoaded = true;
+            std::cout << "Skybox loaded successfully!" << std::endl;
+        });
     }
 
-    std::cout << "Failed to load skybox, using default" << std::endl;
-    return false;
+    return true;
 }
 
 void GameSkybox::draw(const glm::mat4& view, const glm::mat4& projection) {
@@ -200,10 +211,10 @@ void GameSkybox::draw(const glm::mat4& view, const glm::mat4& projection) {
     // Remove translation from view matrix (skybox follows camera but doesn't move)
     glm::mat4 viewNoTranslation = glm::mat4(glm::mat3(view));
 
-    skyboxShader->setMat4("view", glm::value_ptr(viewNoTranslation));
-    skyboxShader->setMat4("projection", glm::value_ptr(projection));
-    skyboxShader->setInt("skybox", 0);
-    skyboxShader->setFloat("brightness", brightness);
+    skyboxShader->setMat4(viewUniform, glm::value_ptr(viewNoTranslation));
+    skyboxShader->setMat4(projectionUniform, glm::value_ptr(projection));
+    skyboxShader->setInt(skyboxUniform, 0);
+    skyboxShader->setFloat(brightnessUniform, brightness);
 
     // Draw skybox
     glBindVertexArray(skyboxVAO);
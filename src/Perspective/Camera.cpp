@@ -134,6 +134,18 @@ void Camera::mouseCallback(double xpos, double ypos){
     cameraFront = glm::normalize(front);
 }
 
+void Camera::setPose(const glm::vec3& position, float yaw, float pitch) {
+    this->yaw = yaw;
+    this->pitch = glm::clamp(pitch, -89.0f, 89.0f);
+    cameraPos = position;
+
+    glm::vec3 front;
+    front.x = cos(glm::radians(this->yaw)) * cos(glm::radians(this->pitch));
+    front.y = sin(glm::radians(this->pitch));
+    front.z = sin(glm::radians(this->yaw)) * cos(glm::radians(this->pitch));
+    cameraFront = glm::normalize(front);
+}
+
 void Camera::updateViewMatrix() {
     view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
 }
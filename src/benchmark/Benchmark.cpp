@@ -0,0 +1,229 @@
+#include "Benchmark.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "Camera.h"
+#include "TerrainManager.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+    // Peak resident set size of the whole process, in bytes
+    size_t getPeakProcessMemory() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // Driver strings may contain quotes, backslashes or control characters
+    std::string escapeJson(const char* text) {
+        std::string escaped;
+        for (const char* c = text; *c; c++) {
+            unsigned char ch = static_cast<unsigned char>(*c);
+            if (ch == '"' || ch == '\\') {
+                escaped += '\\';
+                escaped += *c;
+            }
+            else if (ch < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", ch);
+                escaped += code;
+            }
+            else {
+                escaped += *c;
+            }
+        }
+        return escaped;
+    }
+
+    // Nearest-rank percentile of an already sorted list
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+}
+
+Benchmark::Benchmark(const std::string& reportPath, float frameStep)
+    : reportPath(reportPath), frameStep(frameStep) {
+    // Low pass over the start area, a long straight run that streams in new chunks every
+    // frame, a climb to look down over the whole render distance, then back to the start
+    path = {
+        {  0.0f, glm::vec3(100.0f,  50.0f,  100.0f),  -90.0f, -20.0f },
+        {  8.0f, glm::vec3(100.0f,  60.0f, -300.0f),  -90.0f, -15.0f },
+        { 14.0f, glm::vec3(300.0f,  80.0f, -500.0f),    0.0f, -25.0f },
+        { 22.0f, glm::vec3(800.0f,  40.0f, -500.0f),    0.0f, -10.0f },
+        { 28.0f, glm::vec3(900.0f, 150.0f, -200.0f),   90.0f, -40.0f },
+        { 36.0f, glm::vec3(600.0f,  60.0f,  100.0f),  180.0f, -15.0f },
+        { 40.0f, glm::vec3(100.0f,  50.0f,  100.0f),  270.0f, -20.0f },
+    };
+
+    frameCount = static_cast<int>(path.back().time / frameStep) + 1;
+    frameTimes.reserve(frameCount);
+}
+
+GLFWwindow* Benchmark::createOffscreenWindow(int width, int height, const char* title) {
+    struct ContextAttempt {
+        int platform;
+        int contextApi;
+        const char* name;
+    };
+
+    // OSMesa first so a machine with only Mesa's software rasterizer needs no display
+    const ContextAttempt attempts[] = {
+        { GLFW_PLATFORM_NULL, GLFW_OSMESA_CONTEXT_API, "OSMesa" },
+        { GLFW_PLATFORM_NULL, GLFW_EGL_CONTEXT_API, "EGL (null platform)" },
+        { GLFW_ANY_PLATFORM, GLFW_EGL_CONTEXT_API, "EGL (hidden window)" },
+    };
+
+    for (const ContextAttempt& attempt : attempts) {
+        glfwInitHint(GLFW_PLATFORM, attempt.platform);
+        if (!glfwInit()) continue;
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, attempt.contextApi);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+        GLFWwindow* window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (window) {
+            std::cout << "Benchmark context: " << attempt.name << std::endl;
+            return window;
+        }
+        glfwTerminate();
+    }
+
+    std::cerr << "Failed to create an offscreen OpenGL 3.3 context\n";
+    return nullptr;
+}
+
+CameraKeyframe Benchmark::samplePath(float time) const {
+    if (time <= path.front().time) return path.front();
+    if (time >= path.back().time) return path.back();
+
+    size_t next = 1;
+    while (path[next].time < time) next++;
+    const CameraKeyframe& a = path[next - 1];
+    const CameraKeyframe& b = path[next];
+
+    float t = (time - a.time) / (b.time - a.time);
+    CameraKeyframe pose;
+    pose.time = time;
+    pose.position = glm::mix(a.position, b.position, t);
+    pose.yaw = a.yaw + (b.yaw - a.yaw) * t;
+    pose.pitch = a.pitch + (b.pitch - a.pitch) * t;
+    return pose;
+}
+
+void Benchmark::beginFrame(Camera& camera) {
+    // Simulated time advances by a fixed step, independent of how long frames take
+    CameraKeyframe pose = samplePath(frame * frameStep);
+    camera.setPose(pose.position, pose.yaw, pose.pitch);
+
+    frameStart = std::chrono::steady_clock::now();
+    if (frame == 0) runStart = frameStart;
+}
+
+void Benchmark::endFrame(const TerrainManager& terrain) {
+    glFinish();
+    auto now = std::chrono::steady_clock::now();
+    frameTimes.push_back(std::chrono::duration<double, std::milli>(now - frameStart).count());
+
+    totalDrawCalls += terrain.getDrawCallCount();
+    totalTriangles += terrain.getDrawnTriangleCount();
+    maxDrawCalls = std::max(maxDrawCalls, terrain.getDrawCallCount());
+    frame++;
+}
+
+bool Benchmark::writeReport(const TerrainManager& terrain) const {
+    std::vector<double> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    double frameSum = 0.0;
+    for (double t : sorted) frameSum += t;
+
+    size_t frames = sorted.size();
+    double meanFrame = frames ? frameSum / frames : 0.0;
+    double wallSeconds = frames ? std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count() : 0.0;
+
+    size_t generated = terrain.getGeneratedChunkCount();
+    double generationMs = terrain.getChunkGenerationTime() * 1000.0;
+
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    std::ofstream out(reportPath);
+    if (!out) {
+        std::cerr << "Failed to write benchmark report: " << reportPath << std::endl;
+        return false;
+    }
+
+    out << "{\n";
+    out << "  \"renderer\": \"" << escapeJson(renderer ? renderer : "unknown") << "\",\n";
+    out << "  \"frames\": " << frames << ",\n";
+    out << "  \"frameStepSeconds\": " << frameStep << ",\n";
+    out << "  \"wallTimeSeconds\": " << wallSeconds << ",\n";
+    out << "  \"frameTimeMs\": {\n";
+    out << "    \"mean\": " << meanFrame << ",\n";
+    out << "    \"p50\": " << percentile(sorted, 50.0) << ",\n";
+    out << "    \"p90\": " << percentile(sorted, 90.0) << ",\n";
+    out << "    \"p95\": " << percentile(sorted, 95.0) << ",\n";
+    out << "    \"p99\": " << percentile(sorted, 99.0) << ",\n";
+    out << "    \"max\": " << (frames ? sorted.back() : 0.0) << "\n";
+    out << "  },\n";
+    out << "  \"chunkGeneration\": {\n";
+    out << "    \"count\": " << generated << ",\n";
+    out << "    \"fromCache\": " << terrain.getCachedChunkCount() << ",\n";
+    out << "    \"totalMs\": " << generationMs << ",\n";
+    out << "    \"meanMs\": " << (generated ? generationMs / generated : 0.0) << ",\n";
+    out << "    \"maxMs\": " << terrain.getMaxChunkGenerationTime() * 1000.0 << "\n";
+    out << "  },\n";
+    out << "  \"prefetch\": {\n";
+    out << "    \"requested\": " << terrain.getPrefetchRequestCount() << ",\n";
+    out << "    \"hits\": " << terrain.getPrefetchHitCount() << ",\n";
+    out << "    \"late\": " << terrain.getPrefetchLateCount() << ",\n";
+    out << "    \"evictedUnused\": " << terrain.getPrefetchWastedCount() << ",\n";
+    out << "    \"hitRate\": " << terrain.getPrefetchHitRate() << "\n";
+    out << "  },\n";
+    out << "  \"terrainDrawCalls\": {\n";
+    out << "    \"total\": " << totalDrawCalls << ",\n";
+    out << "    \"meanPerFrame\": " << (frames ? static_cast<double>(totalDrawCalls) / frames : 0.0) << ",\n";
+    out << "    \"maxPerFrame\": " << maxDrawCalls << "\n";
+    out << "  },\n";
+    out << "  \"meanTrianglesPerFrame\": " << (frames ? static_cast<double>(totalTriangles) / frames : 0.0) << ",\n";
+    out << "  \"memory\": {\n";
+    out << "    \"peakChunkBytes\": " << terrain.getPeakMemoryUsage() << ",\n";
+    out << "    \"peakAllocatedChunkBytes\": " << terrain.getPeakAllocatedMemoryUsage() << ",\n";
+    out << "    \"chunkBudgetBytes\": " << std::max(terrain.memoryBudget, terrain.getMinimumMemoryBudget()) << ",\n";
+    out << "    \"peakProcessBytes\": " << getPeakProcessMemory() << "\n";
+    out << "  }\n";
+    out << "}\n";
+
+    std::cout << "Benchmark: " << frames << " frames, p50 " << percentile(sorted, 50.0)
+              << " ms, p99 " << percentile(sorted, 99.0) << " ms, report written to "
+              << reportPath << std::endl;
+    return true;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <memory>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -11,11 +13,15 @@
 #include "backends/imgui_impl_opengl3.h"
 
 #include "Shader.h"
+#include "ShaderManager.h"
 #include "Camera.h"
 #include "TerrainManager.h"
 #include "TerrainChunk.h"
 #include "TextureManager.h"
 #include "GameSkybox.h"
+#include "ImageLoader.h"
+#include "NoiseBenchmark.h"
+#include "Benchmark.h"
 
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
@@ -24,24 +30,59 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
 }
 
-int main() {
-    // Initialize GLFW
-    if (!glfwInit()) {
-        std::cout << "Failed to initialize GLFW" << std::endl;
-        return -1;
+int main(int argc, char** argv) {
+    std::unique_ptr<Benchmark> benchmark;
+    bool noHeightmapCache = false;
+    bool forceHeightmapCache = false;
+
+    for (int i = 1; i < argc; i++) {
+        // Noise kernel microbenchmark, no window needed
+        if (std::strcmp(argv[i], "--bench-noise") == 0) {
+            return runNoiseBenchmark();
+        }
+        // Offscreen scripted flythrough: --benchmark [report.json]
+        if (std::strcmp(argv[i], "--benchmark") == 0) {
+            const char* reportPath = "benchmark.json";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                reportPath = argv[++i];
+            }
+            benchmark.reset(new Benchmark(reportPath));
+        }
+        // Always evaluate noise, e.g. to profile generation itself
+        if (std::strcmp(argv[i], "--no-heightmap-cache") == 0) {
+            noHeightmapCache = true;
+        }
+        // Benchmarks skip the cache so generation timings don't depend on earlier runs
+        if (std::strcmp(argv[i], "--heightmap-cache") == 0) {
+            forceHeightmapCache = true;
+        }
     }
+    bool useHeightmapCache = !noHeightmapCache && (!benchmark || forceHeightmapCache);
 
-    // Configure GLFW
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // Create window
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Real-Time Terrain", nullptr, nullptr);
-    if (!window) {
-        std::cerr << "Failed to create GLFW window\n";
-        glfwTerminate();
-        return -1;
+    GLFWwindow* window = nullptr;
+    if (benchmark) {
+        window = Benchmark::createOffscreenWindow(SCR_WIDTH, SCR_HEIGHT, "Real-Time Terrain");
+        if (!window) return -1;
+    }
+    else {
+        // Initialize GLFW
+        if (!glfwInit()) {
+            std::cout << "Failed to initialize GLFW" << std::endl;
+            return -1;
+        }
+
+        // Configure GLFW
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        // Create window
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Real-Time Terrain", nullptr, nullptr);
+        if (!window) {
+            std::cerr << "Failed to create GLFW window\n";
+            glfwTerminate();
+            return -1;
+        }
     }
 
     glfwMakeContextCurrent(window);
@@ -59,21 +100,6 @@ int main() {
     // Preload textures
     TextureManager& texManager = TextureManager::getInstance();
 
-    // Load all PBR texture sets
-    texManager.loadPBRTextureSet("sand",
-        "Assets/Textures/Ground093C_2K-JPG");
-
-    texManager.loadPBRTextureSet("grass",
-        "Assets/Textures/Grass001_2K-JPG");
-
-    texManager.loadPBRTextureSet("rock",
-        "Assets/Textures/Rock020_2K-JPG");
-
-    texManager.loadPBRTextureSet("snow",
-        "Assets/Textures/Snow004_2K-JPG");
-
-
-
     // Create camera
     Camera camera(SCR_WIDTH, SCR_HEIGHT, -90.0f, -20.0f, true, 0.1f, 50.0f, window);
     GameSkybox skybox;
@@ -89,14 +115,44 @@ int main() {
         "Assets/Textures/Skybox2/cubemap_8192x4096_V2/back.jpg"
     };
 
-    if (!skybox.loadCubemap(faces)) {
-        std::cout << "Using default gradient skybox" << std::endl;
+    {
+        // Every startup image decodes on worker threads; uploads run here as each one lands
+        ImageLoader imageLoader;
+
+        // Skybox faces are by far the largest files, so they start first; the result is
+        // only known once they have all decoded
+        skybox.loadCubemap(imageLoader, faces);
+
+        // Load all PBR texture sets
+        texManager.loadPBRTextureSet(imageLoader, "sand",
+            "Assets/Textures/Ground093C_2K-JPG");
+
+        texManager.loadPBRTextureSet(imageLoader, "grass",
+            "Assets/Textures/Grass001_2K-JPG");
+
+        texManager.loadPBRTextureSet(imageLoader, "rock",
+            "Assets/Textures/Rock020_2K-JPG");
+
+        texManager.loadPBRTextureSet(imageLoader, "snow",
+            "Assets/Textures/Snow004_2K-JPG");
+
+        imageLoader.finish();
+
+        if (!skybox.isCubemapLoaded()) {
+            std::cout << "Using default gradient skybox" << std::endl;
+        }
     }
+
+    // Terrain samples every material set through one texture array per map type
+    texManager.buildPBRTextureArrays({ "sand", "grass", "rock", "snow" });
+
     // Load terrain manager
     TerrainManager terrainManager;
+    terrainManager.useHeightmapCache = useHeightmapCache;
 
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-    glfwSwapInterval(1);
+    // Benchmark frames must not wait on vsync
+    glfwSwapInterval(benchmark ? 0 : 1);
 
     // Initialize Dear ImGui
     IMGUI_CHECKVERSION();
@@ -121,8 +177,14 @@ int main() {
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        // Process input
-        camera.processInput(window, deltaTime);
+        // Process input, or follow the scripted path when benchmarking
+        if (benchmark) {
+            deltaTime = benchmark->getFrameStep();
+            benchmark->beginFrame(camera);
+        }
+        else {
+            camera.processInput(window, deltaTime);
+        }
         camera.updateViewMatrix();
 
         // Clear buffers
@@ -144,23 +206,73 @@ int main() {
             camera.getCameraPos().x,
             camera.getCameraPos().y,
             camera.getCameraPos().z);
+        ImGui::Text("Chunks: %zu resident, %zu pending, %zu evicted",
+            terrainManager.getResidentChunkCount(),
+            terrainManager.getPendingChunkCount(),
+            terrainManager.getEvictedChunkCount());
+        ImGui::Text("Build queue: %zu waiting, %zu generating, %zu cancelled",
+            terrainManager.getQueuedChunkCount(),
+            terrainManager.getInFlightChunkCount(),
+            terrainManager.getCancelledChunkCount());
+        ImGui::Text("Main-thread chunk work: %.2f ms, backlog %zu uploads, %zu destroys",
+            terrainManager.getMainThreadWorkTime() * 1000.0,
+            terrainManager.getUploadBacklog(),
+            terrainManager.getDestroyBacklog());
+        ImGui::SliderFloat("Chunk work budget", &terrainManager.mainThreadBudgetMs, 0.25f, 8.0f, "%.2f ms");
+        ImGui::Text("Chunks generated: %zu (%zu from disk cache)",
+            terrainManager.getGeneratedChunkCount(),
+            terrainManager.getCachedChunkCount());
+        ImGui::Text("Prefetch: %zu requested, %.0f%% hit (%zu late, %zu evicted unused)",
+            terrainManager.getPrefetchRequestCount(),
+            terrainManager.getPrefetchHitRate() * 100.0f,
+            terrainManager.getPrefetchLateCount(),
+            terrainManager.getPrefetchWastedCount());
+        ImGui::SliderFloat("Prefetch seconds", &terrainManager.prefetchSeconds, 0.0f, 5.0f, "%.1f s");
+        ImGui::Text("Chunks drawn: %d, culled: %d",
+            terrainManager.getDrawnChunkCount(),
+            terrainManager.getCulledChunkCount());
+        ImGui::Text("Terrain triangles: %d", terrainManager.getDrawnTriangleCount());
+        ImGui::Text("Terrain shader permutations: %d", terrainManager.getProgramBindCount());
+        ImGui::Text("Chunk memory: %.1f / %.1f MB (peak %.1f MB)",
+            terrainManager.getMemoryUsage() / (1024.0f * 1024.0f),
+            terrainManager.memoryBudget / (1024.0f * 1024.0f),
+            terrainManager.getPeakMemoryUsage() / (1024.0f * 1024.0f));
+        ImGui::Text("Chunk memory allocated: %.1f MB (peak %.1f MB, minimum budget %.1f MB)",
+            terrainManager.getAllocatedMemoryUsage() / (1024.0f * 1024.0f),
+            terrainManager.getPeakAllocatedMemoryUsage() / (1024.0f * 1024.0f),
+            terrainManager.getMinimumMemoryBudget() / (1024.0f * 1024.0f));
         ImGui::End();
         glClear(GL_DEPTH_BUFFER_BIT);  // Clear depth only
         skybox.draw(camera.getViewMatrix(), camera.getProjectionMatrix());
 
         // Render terrain
-        terrainManager.update(camera);
+        terrainManager.update(camera, deltaTime);
 
         // Render ImGui
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+        if (benchmark) {
+            benchmark->endFrame(terrainManager);
+            if (benchmark->isFinished()) {
+                glfwSetWindowShouldClose(window, true);
+            }
+        }
+
         // Swap buffers and poll events
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    int exitCode = 0;
+    if (benchmark && !benchmark->writeReport(terrainManager)) {
+        exitCode = 1;
+    }
+
     // Cleanup
+    terrainManager.releaseChunks();
+    ShaderManager::getInstance().clear();
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -168,5 +280,5 @@ int main() {
     glfwDestroyWindow(window);
     glfwTerminate();
 
-    return 0;
+    return exitCode;
 }
@@ -2,8 +2,23 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
-Shader::Shader(const char* vPath, const char* fPath)
+// Places the defines right after the #version directive, which must stay first
+static std::string injectDefines(const std::string& source, const std::string& defines) {
+    if (defines.empty()) return source;
+
+    size_t versionPos = source.find("#version");
+    if (versionPos == std::string::npos) return defines + source;
+
+    size_t lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos) return source + "\n" + defines;
+
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
+Shader::Shader(const char* vPath, const char* fPath, const std::string& defines)
 {
     std::string vCode, fCode;
     std::ifstream vFile, fFile;
@@ -15,8 +30,8 @@ Shader::Shader(const char* vPath, const char* fPath)
     vStream << vFile.rdbuf();
     fStream << fFile.rdbuf();
 
-    vCode = vStream.str();
-    fCode = fStream.str();
+    vCode = injectDefines(vStream.str(), defines);
+    fCode = injectDefines(fStream.str(), defines);
 
     const char* vSrc = vCode.c_str();
     const char* fSrc = fCode.c_str();
@@ -36,25 +51,106 @@ Shader::Shader(const char* vPath, const char* fPath)
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    reflectUniforms();
+}
+
+void Shader::reflectUniforms() {
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> nameBuffer(maxLength > 0 ? maxLength : 1);
+    uniforms.reserve(count);
+
+    auto addUniform = [this](const std::string& name, GLint location) {
+        UniformEntry entry;
+        entry.hash = hashName(name.c_str());
+        entry.location = location;
+        entry.name = name;
+        uniforms.push_back(entry);
+    };
+
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint arraySize = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, static_cast<GLsizei>(nameBuffer.size()), &length, &arraySize, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        addUniform(name, location);
+
+        // Arrays are reported as "name[0]"; register them under "name" as well
+        const std::string arraySuffix = "[0]";
+        if (name.size() > arraySuffix.size()
+            && name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0) {
+            addUniform(name.substr(0, name.size() - arraySuffix.size()), location);
+        }
+    }
+
+    std::sort(uniforms.begin(), uniforms.end(),
+        [](const UniformEntry& a, const UniformEntry& b) { return a.hash < b.hash; });
+}
+
+Shader::~Shader() {
+    glDeleteProgram(ID);
 }
 
 void Shader::use() {
     glUseProgram(ID);
 }
 
-void Shader::setMat4(const std::string &name, const float* mat) {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, mat);
+UniformLocation Shader::getUniform(const char* name) const {
+    uint32_t hash = hashName(name);
+
+    auto it = std::lower_bound(uniforms.begin(), uniforms.end(), hash,
+        [](const UniformEntry& entry, uint32_t value) { return entry.hash < value; });
+
+    // Walk the (almost always single) run of equal hashes to rule out collisions
+    for (; it != uniforms.end() && it->hash == hash; ++it) {
+        if (std::strcmp(it->name.c_str(), name) == 0) {
+            UniformLocation uniform;
+            uniform.location = it->location;
+            return uniform;
+        }
+    }
+    return UniformLocation();
+}
+
+void Shader::setMat4(const char* name, const float* mat) {
+    setMat4(getUniform(name), mat);
+}
+
+void Shader::setInt(const char* name, int value) {
+    setInt(getUniform(name), value);
 }
 
+void Shader::setFloat(const char* name, float value) {
+    setFloat(getUniform(name), value);
+}
+
+void Shader::setVec3(const char* name, const glm::vec3& value) {
+    setVec3(getUniform(name), value);
+}
+
+void Shader::setMat4(UniformLocation uniform, const float* mat) {
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, mat);
+}
+
+void Shader::setInt(UniformLocation uniform, int value) {
+    glUniform1i(uniform.location, value);
+}
 
-void Shader::setInt(const std::string& name, int value) {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+void Shader::setFloat(UniformLocation uniform, float value) {
+    glUniform1f(uniform.location, value);
 }
 
-void Shader::setFloat(const std::string& name, float value) {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+void Shader::setIntArray(UniformLocation uniform, const int* values, int count) {
+    glUniform1iv(uniform.location, count, values);
 }
 
-void Shader::setVec3(const std::string& name, const glm::vec3& value) {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+void Shader::setVec3(UniformLocation uniform, const glm::vec3& value) {
+    glUniform3fv(uniform.location, 1, &value[0]);
 }
@@ -0,0 +1,26 @@
+#include "ShaderManager.h"
+#include <iostream>
+
+ShaderManager& ShaderManager::getInstance() {
+    static ShaderManager instance;
+    return instance;
+}
+
+std::shared_ptr<Shader> ShaderManager::getShader(const std::string& vertexPath, const std::string& fragmentPath,
+    const std::string& defines) {
+    std::string key = vertexPath + "|" + fragmentPath + "|" + defines;
+
+    auto it = shaders.find(key);
+    if (it != shaders.end()) {
+        return it->second;
+    }
+
+    std::shared_ptr<Shader> shader = std::make_shared<Shader>(vertexPath.c_str(), fragmentPath.c_str(), defines);
+    shaders[key] = shader;
+    std::cout << "Compiled shader program: " << vertexPath << " + " << fragmentPath << std::endl;
+    return shader;
+}
+
+void ShaderManager::clear() {
+    shaders.clear();
+}
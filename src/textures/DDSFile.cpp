@@ -0,0 +1,227 @@
+#include "DDSFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+namespace {
+
+    const uint32_t DDS_MAGIC = 0x20534444;   // "DDS "
+    const uint32_t DDS_HEADER_SIZE = 124;
+    const uint32_t DDS_PIXELFORMAT_SIZE = 32;
+
+    const uint32_t DDSD_CAPS = 0x1;
+    const uint32_t DDSD_HEIGHT = 0x2;
+    const uint32_t DDSD_WIDTH = 0x4;
+    const uint32_t DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    const uint32_t DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDSCAPS_COMPLEX = 0x8;
+    const uint32_t DDSCAPS_TEXTURE = 0x1000;
+    const uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+    const uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+    const uint32_t DXGI_FORMAT_BC1_UNORM_SRGB = 72;
+    const uint32_t DXGI_FORMAT_BC4_UNORM = 80;
+    const uint32_t DXGI_FORMAT_BC5_UNORM = 83;
+    const uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+    // Largest side any GL 3.3 driver we target accepts; anything bigger is a corrupt header
+    const uint32_t DDS_MAX_DIMENSION = 16384;
+
+    // Header word indices, counted from dwSize
+    enum {
+        HeaderFlags = 1, HeaderHeight = 2, HeaderWidth = 3, HeaderLinearSize = 4,
+        HeaderMipCount = 6, PixelFormatSize = 18, PixelFormatFlags = 19, PixelFormatFourCC = 20,
+        HeaderCaps = 26, HeaderWords = 31
+    };
+
+    constexpr uint32_t fourCC(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+               (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    DDSFormat formatFromFourCC(uint32_t code) {
+        if (code == fourCC('D', 'X', 'T', '1')) return DDSFormat_BC1;
+        if (code == fourCC('A', 'T', 'I', '1') || code == fourCC('B', 'C', '4', 'U')) return DDSFormat_BC4;
+        if (code == fourCC('A', 'T', 'I', '2') || code == fourCC('B', 'C', '5', 'U')) return DDSFormat_BC5;
+        return DDSFormat_Unknown;
+    }
+
+    DDSFormat formatFromDXGI(uint32_t dxgiFormat) {
+        switch (dxgiFormat) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB: return DDSFormat_BC1;
+        case DXGI_FORMAT_BC4_UNORM: return DDSFormat_BC4;
+        case DXGI_FORMAT_BC5_UNORM: return DDSFormat_BC5;
+        default: return DDSFormat_Unknown;
+        }
+    }
+
+    bool getModifiedTime(const std::string& path, long long& time) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+        time = static_cast<long long>(info.st_mtime);
+        return true;
+    }
+
+    uint32_t formatToDXGI(DDSFormat format) {
+        switch (format) {
+        case DDSFormat_BC1: return DXGI_FORMAT_BC1_UNORM;
+        case DDSFormat_BC4: return DXGI_FORMAT_BC4_UNORM;
+        case DDSFormat_BC5: return DXGI_FORMAT_BC5_UNORM;
+        default: return 0;
+        }
+    }
+}
+
+size_t getDDSBlockBytes(DDSFormat format) {
+    switch (format) {
+    case DDSFormat_BC1:
+    case DDSFormat_BC4: return 8;
+    case DDSFormat_BC5: return 16;
+    default: return 0;
+    }
+}
+
+size_t getDDSLevelSize(DDSFormat format, int width, int height) {
+    size_t blocksX = (std::max(width, 1) + 3) / 4;
+    size_t blocksY = (std::max(height, 1) + 3) / 4;
+    return blocksX * blocksY * getDDSBlockBytes(format);
+}
+
+const char* getDDSFormatName(DDSFormat format) {
+    switch (format) {
+    case DDSFormat_BC1: return "BC1";
+    case DDSFormat_BC4: return "BC4";
+    case DDSFormat_BC5: return "BC5";
+    default: return "unknown";
+    }
+}
+
+std::string getDDSCachePath(const std::string& sourcePath) {
+    size_t dot = sourcePath.find_last_of('.');
+    size_t slash = sourcePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return sourcePath + ".dds";
+    }
+    return sourcePath.substr(0, dot) + ".dds";
+}
+
+bool isDDSCacheCurrent(const std::string& sourcePath, const std::string& cachePath) {
+    long long cacheTime = 0, sourceTime = 0;
+    if (!getModifiedTime(cachePath, cacheTime)) return false;
+    if (!getModifiedTime(sourcePath, sourceTime)) return true;
+    return cacheTime >= sourceTime;
+}
+
+bool loadDDS(const std::string& path, DDSImage& image) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    uint32_t magic = 0;
+    uint32_t header[HeaderWords] = {};
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || magic != DDS_MAGIC || header[0] != DDS_HEADER_SIZE || header[PixelFormatSize] != DDS_PIXELFORMAT_SIZE) {
+        std::cout << "Invalid DDS file: " << path << std::endl;
+        return false;
+    }
+
+    DDSFormat format = DDSFormat_Unknown;
+    if (header[PixelFormatFlags] & DDPF_FOURCC) {
+        if (header[PixelFormatFourCC] == fourCC('D', 'X', '1', '0')) {
+            uint32_t dx10[5] = {};
+            file.read(reinterpret_cast<char*>(dx10), sizeof(dx10));
+            if (file && dx10[1] == D3D10_RESOURCE_DIMENSION_TEXTURE2D && dx10[3] <= 1) {
+                format = formatFromDXGI(dx10[0]);
+            }
+        }
+        else {
+            format = formatFromFourCC(header[PixelFormatFourCC]);
+        }
+    }
+
+    if (format == DDSFormat_Unknown) {
+        std::cout << "Unsupported DDS format (expected BC1/BC4/BC5): " << path << std::endl;
+        return false;
+    }
+
+    uint32_t headerWidth = header[HeaderWidth];
+    uint32_t headerHeight = header[HeaderHeight];
+    if (headerWidth == 0 || headerHeight == 0 || headerWidth > DDS_MAX_DIMENSION || headerHeight > DDS_MAX_DIMENSION) {
+        std::cout << "Invalid DDS dimensions " << headerWidth << "x" << headerHeight << ": " << path << std::endl;
+        return false;
+    }
+
+    image.format = format;
+    image.width = static_cast<int>(headerWidth);
+    image.height = static_cast<int>(headerHeight);
+
+    // No more levels than the full chain down to 1x1
+    int fullChain = 1;
+    for (uint32_t side = std::max(headerWidth, headerHeight); side > 1; side /= 2) {
+        fullChain++;
+    }
+    uint32_t headerMips = (header[HeaderFlags] & DDSD_MIPMAPCOUNT) ? header[HeaderMipCount] : 1;
+    int mipCount = static_cast<int>(std::min<uint32_t>(std::max<uint32_t>(headerMips, 1), fullChain));
+
+    // Lay out the mip chain, then read it in one go
+    image.mips.clear();
+    size_t offset = 0;
+    int width = image.width;
+    int height = image.height;
+    for (int level = 0; level < mipCount; level++) {
+        size_t size = getDDSLevelSize(format, width, height);
+        image.mips.push_back({ width, height, offset, size });
+        offset += size;
+        if (width == 1 && height == 1) break;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    // Check against what is actually left in the file before allocating
+    std::streamoff dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff fileEnd = file.tellg();
+    file.seekg(dataStart);
+    if (!file || dataStart < 0 || static_cast<unsigned long long>(fileEnd - dataStart) < offset) {
+        std::cout << "Truncated DDS file: " << path << std::endl;
+        return false;
+    }
+
+    image.data.resize(offset);
+    file.read(reinterpret_cast<char*>(image.data.data()), offset);
+    if (!file) {
+        std::cout << "Truncated DDS file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool saveDDS(const std::string& path, const DDSImage& image) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    uint32_t header[HeaderWords] = {};
+    header[0] = DDS_HEADER_SIZE;
+    header[HeaderFlags] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header[HeaderHeight] = static_cast<uint32_t>(image.height);
+    header[HeaderWidth] = static_cast<uint32_t>(image.width);
+    header[HeaderLinearSize] = static_cast<uint32_t>(image.mips.empty() ? 0 : image.mips[0].size);
+    header[HeaderMipCount] = static_cast<uint32_t>(image.mips.size());
+    header[PixelFormatSize] = DDS_PIXELFORMAT_SIZE;
+    header[PixelFormatFlags] = DDPF_FOURCC;
+    header[PixelFormatFourCC] = fourCC('D', 'X', '1', '0');
+    header[HeaderCaps] = DDSCAPS_TEXTURE | (image.mips.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    uint32_t dx10[5] = { formatToDXGI(image.format), D3D10_RESOURCE_DIMENSION_TEXTURE2D, 0, 1, 0 };
+
+    file.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(dx10), sizeof(dx10));
+    file.write(reinterpret_cast<const char*>(image.data.data()), image.data.size());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,115 @@
+#include "ImageLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "stb_image.h"
+
+ImageLoader::ImageLoader(unsigned int threadCount)
+    : pool(new ThreadPool(threadCount)) {
+    // stb_image's flip flag is a global the workers would race on, so it stays off while
+    // they run and decode() flips rows itself
+    stbi_set_flip_vertically_on_load(false);
+}
+
+ImageLoader::~ImageLoader() {
+    pool.reset();
+
+    // Free anything decoded but never handed out
+    for (Result& result : results) {
+        stbi_image_free(result.image.pixels);
+    }
+}
+
+void ImageLoader::decode(DecodedImage& image, bool flipVertically) {
+    auto start = std::chrono::steady_clock::now();
+    image.pixels = stbi_load(image.path.c_str(), &image.width, &image.height, &image.channels, 0);
+
+    if (image.pixels && flipVertically) {
+        size_t rowBytes = static_cast<size_t>(image.width) * image.channels;
+        std::vector<unsigned char> row(rowBytes);
+        for (int y = 0; y < image.height / 2; y++) {
+            unsigned char* top = image.pixels + y * rowBytes;
+            unsigned char* bottom = image.pixels + (image.height - 1 - y) * rowBytes;
+            std::memcpy(row.data(), top, rowBytes);
+            std::memcpy(top, bottom, rowBytes);
+            std::memcpy(bottom, row.data(), rowBytes);
+        }
+    }
+
+    image.decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ImageLoader::request(const std::string& path, bool flipVertically, Callback onDecoded) {
+    size_t requestIndex = callbacks.size();
+    if (requestIndex == delivered) {
+        batchStart = std::chrono::steady_clock::now();
+    }
+    callbacks.push_back(std::move(onDecoded));
+
+    pool->submit([this, path, flipVertically, requestIndex]() {
+        Result result;
+        result.image.path = path;
+        result.requestIndex = requestIndex;
+        decode(result.image, flipVertically);
+
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results.push_back(std::move(result));
+        }
+        resultReady.notify_one();
+    });
+}
+
+void ImageLoader::finish() {
+    double totalDecodeMs = 0.0;
+    double longestDecodeMs = 0.0;
+    std::string longestPath;
+    size_t firstDelivered = delivered;
+
+    while (delivered < callbacks.size()) {
+        std::vector<Result> ready;
+        {
+            std::unique_lock<std::mutex> lock(resultMutex);
+            resultReady.wait(lock, [this] { return !results.empty(); });
+            ready.swap(results);
+        }
+
+        for (Result& result : ready) {
+            const DecodedImage& image = result.image;
+
+            // Moved out first: the callback may request() more images, which can
+            // reallocate callbacks while it runs
+            Callback onDecoded = std::move(callbacks[result.requestIndex]);
+            callbacks[result.requestIndex] = nullptr;
+
+            auto uploadStart = std::chrono::steady_clock::now();
+            if (onDecoded) {
+                onDecoded(image);
+            }
+            double uploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+
+            std::cout << "Decoded " << image.path << " (" << image.width << "x" << image.height
+                      << ") in " << image.decodeMs << " ms, upload " << uploadMs << " ms" << std::endl;
+
+            totalDecodeMs += image.decodeMs;
+            if (image.decodeMs > longestDecodeMs) {
+                longestDecodeMs = image.decodeMs;
+                longestPath = image.path;
+            }
+
+            stbi_image_free(result.image.pixels);
+            result.image.pixels = nullptr;
+            delivered++;
+        }
+    }
+
+    // Includes images requested by callbacks during this call
+    size_t requested = delivered - firstDelivered;
+    if (requested > 0) {
+        double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+        std::cout << "Loaded " << requested << " images in " << wallMs << " ms on " << pool->size()
+                  << " threads (" << totalDecodeMs << " ms of decoding, longest " << longestDecodeMs
+                  << " ms: " << longestPath << ")" << std::endl;
+    }
+}
@@ -0,0 +1,59 @@
+#include "ORMPacker.h"
+
+std::string getORMSourcePath(const std::string& prefix, ORMChannel channel) {
+    switch (channel) {
+    case ORMChannel_AO: return prefix + "_AmbientOcclusion.jpg";
+    case ORMChannel_Roughness: return prefix + "_Roughness.jpg";
+    case ORMChannel_Displacement: return prefix + "_Displacement.jpg";
+    default: return prefix;
+    }
+}
+
+std::string getORMCachePath(const std::string& prefix) {
+    return prefix + "_ORM.dds";
+}
+
+ORMSource makeORMSource(const unsigned char* pixels, int width, int height, int channels) {
+    ORMSource source;
+    if (!pixels || channels <= 0) return source;
+
+    source.width = width;
+    source.height = height;
+    source.pixels.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < source.pixels.size(); i++) {
+        source.pixels[i] = pixels[i * channels];
+    }
+    return source;
+}
+
+bool packORM(const ORMSource sources[ORMChannel_Count], std::vector<unsigned char>& rgb, int& width, int& height) {
+    const unsigned char defaults[ORMChannel_Count] = { 255, 128, 0 };
+
+    width = 0;
+    height = 0;
+    for (int c = 0; c < ORMChannel_Count; c++) {
+        if (sources[c].pixels.empty()) continue;
+        if (sources[c].width * sources[c].height > width * height) {
+            width = sources[c].width;
+            height = sources[c].height;
+        }
+    }
+    if (width == 0 || height == 0) return false;
+
+    rgb.resize(static_cast<size_t>(width) * height * 3);
+    for (int c = 0; c < ORMChannel_Count; c++) {
+        const ORMSource& source = sources[c];
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                unsigned char value = defaults[c];
+                if (!source.pixels.empty()) {
+                    int sx = x * source.width / width;
+                    int sy = y * source.height / height;
+                    value = source.pixels[static_cast<size_t>(sy) * source.width + sx];
+                }
+                rgb[(static_cast<size_t>(y) * width + x) * 3 + c] = value;
+            }
+        }
+    }
+    return true;
+}
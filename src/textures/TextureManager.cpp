@@ -1,7 +1,11 @@
 #include "TextureManager.h"
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include "stb_image.h"
+#include "DDSFile.h"
+#include "ORMPacker.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -14,53 +18,129 @@
 #define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
 #endif
 
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+namespace {
+
+    // Wrap, trilinear and anisotropic filtering shared by every material texture
+    void setMaterialSampling(GLenum target = GL_TEXTURE_2D) {
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // Enable anisotropic filtering if available
+        if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
+            float maxAnisotropy = 0.0f;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+            glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
+        }
+    }
+
+    const int PBR_MAP_TYPES = 3;
+    const char* const pbrMapTypes[PBR_MAP_TYPES] = { "albedo", "normal", "orm" };
+    // Stand-ins for a missing map: magenta, flat normal, AO 1 / roughness 0.5 / no displacement
+    const unsigned char pbrStandInFills[PBR_MAP_TYPES][4] = {
+        { 255, 0, 255, 255 }, { 128, 128, 255, 255 }, { 255, 128, 0, 255 }
+    };
+
+    int getFullMipCount(int width, int height) {
+        int levels = 1;
+        while (width > 1 || height > 1) {
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+            levels++;
+        }
+        return levels;
+    }
+}
+
 TextureManager& TextureManager::getInstance() {
     static TextureManager instance;
     return instance;
 }
 
 unsigned int TextureManager::loadTextureFromFile(const std::string& path) {
-    int width, height, nrChannels;
+    unsigned int compressedID = loadCompressedTexture(path);
+    if (compressedID != 0) return compressedID;
+
+    DecodedImage image;
+    image.path = path;
     stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+
+    unsigned int textureID = createTexture(image);
+    stbi_image_free(image.pixels);
+    return textureID;
+}
 
+unsigned int TextureManager::createTexture(const DecodedImage& image) {
     unsigned int textureID = 0;
 
-    if (data) {
+    if (image.pixels) {
         glGenTextures(1, &textureID);
         glBindTexture(GL_TEXTURE_2D, textureID);
-
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Enable anisotropic filtering if available
-        if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
-            float maxAnisotropy = 0.0f;
-            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
-        }
+        setMaterialSampling();
 
         GLenum format = GL_RGB;
-        if (nrChannels == 1)
+        if (image.channels == 1)
             format = GL_RED;
-        else if (nrChannels == 3)
+        else if (image.channels == 3)
             format = GL_RGB;
-        else if (nrChannels == 4)
+        else if (image.channels == 4)
             format = GL_RGBA;
 
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
         glGenerateMipmap(GL_TEXTURE_2D);
 
-        stbi_image_free(data);
-        std::cout << "Loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
+        std::cout << "Loaded texture: " << image.path << " (" << image.width << "x" << image.height << ")" << std::endl;
     }
     else {
-        std::cout << "Failed to load texture: " << path << std::endl;
+        std::cout << "Failed to load texture: " << image.path << std::endl;
+    }
+
+    return textureID;
+}
+
+unsigned int TextureManager::loadCompressedTexture(const std::string& sourcePath) {
+    std::string cachePath = getDDSCachePath(sourcePath);
+    if (!isDDSCacheCurrent(sourcePath, cachePath)) return 0;
+    return loadDDSTexture(cachePath);
+}
+
+unsigned int TextureManager::loadDDSTexture(const std::string& cachePath) {
+    DDSImage dds;
+    if (!loadDDS(cachePath, dds)) return 0;
+
+    GLenum internalFormat = 0;
+    switch (dds.format) {
+    case DDSFormat_BC1:
+        // S3TC is an extension in GL 3.3, though every desktop driver has it
+        if (!glfwExtensionSupported("GL_EXT_texture_compression_s3tc")) return 0;
+        internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        break;
+    case DDSFormat_BC4: internalFormat = GL_COMPRESSED_RED_RGTC1; break;
+    case DDSFormat_BC5: internalFormat = GL_COMPRESSED_RG_RGTC2; break;
+    default: return 0;
+    }
+
+    unsigned int textureID = 0;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    setMaterialSampling();
+
+    // Mips come from the file; no glGenerateMipmap
+    for (size_t level = 0; level < dds.mips.size(); level++) {
+        const DDSMipLevel& mip = dds.mips[level];
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internalFormat, mip.width, mip.height, 0,
+            static_cast<GLsizei>(mip.size), dds.data.data() + mip.offset);
     }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(dds.mips.size()) - 1);
 
+    std::cout << "Loaded texture: " << cachePath << " (" << dds.width << "x" << dds.height << ", "
+              << getDDSFormatName(dds.format) << ", " << dds.mips.size() << " mips)" << std::endl;
     return textureID;
 }
 
@@ -88,63 +168,128 @@ void TextureManager::bindTexture(const std::string& name, GLuint textureUnit) {
     }
 }
 
+std::string TextureManager::getPBRFilePrefix(const std::string& name) {
+    if (name == "grass") return "Grass001_2K-JPG";
+    if (name == "rock") return "Rock020_2K-JPG";
+    if (name == "snow") return "Snow004_2K-JPG";
+    if (name == "sand") return "Ground093C_2K-JPG";
+    return "";
+}
+
 void TextureManager::loadPBRTextureSet(const std::string& name, const std::string& basePath) {
-    std::unordered_map<std::string, unsigned int> textureSet;
-
-    std::vector<std::pair<std::string, std::string>> textureTypes;
-
-    if (name == "grass") {
-        textureTypes = {
-            {"albedo", "Grass001_2K-JPG_Color.jpg"},
-            {"normal", "Grass001_2K-JPG_NormalGL.jpg"},
-            {"roughness", "Grass001_2K-JPG_Roughness.jpg"},
-            {"ao", "Grass001_2K-JPG_AmbientOcclusion.jpg"},
-            {"displacement", "Grass001_2K-JPG_Displacement.jpg"}
-        };
-    }
-    else if (name == "rock") {
-        textureTypes = {
-            {"albedo", "Rock020_2K-JPG_Color.jpg"},
-            {"normal", "Rock020_2K-JPG_NormalGL.jpg"},
-            {"roughness", "Rock020_2K-JPG_Roughness.jpg"},
-            {"ao", "Rock020_2K-JPG_AmbientOcclusion.jpg"},
-            {"displacement", "Rock020_2K-JPG_Displacement.jpg"}
-        };
-    }
-
-    else if (name == "snow") {
-        textureTypes = {
-            {"albedo", "Snow004_2K-JPG_Color.jpg"},
-            {"normal", "Snow004_2K-JPG_NormalGL.jpg"},
-            {"roughness", "Snow004_2K-JPG_Roughness.jpg"},
-            {"ao", "Snow004_2K-JPG_AmbientOcclusion.jpg"},
-            {"displacement", "Snow004_2K-JPG_Displacement.jpg"}
-        };
-    }
-    else if (name == "sand") {
-        textureTypes = {
-            {"albedo", "Ground093C_2K-JPG_Color.jpg"},
-            {"normal", "Ground093C_2K-JPG_NormalGL.jpg"},
-            {"roughness", "Ground093C_2K-JPG_Roughness.jpg"},
-            {"ao", "Ground093C_2K-JPG_AmbientOcclusion.jpg"},
-            { "displacement", "Ground093C_2K-JPG_Displacement.jpg" }
-
-        };
+    ImageLoader loader;
+    loadPBRTextureSet(loader, name, basePath);
+    loader.finish();
+}
+
+void TextureManager::loadPBRTextureSet(ImageLoader& loader, const std::string& name, const std::string& basePath) {
+    std::string filePrefix = getPBRFilePrefix(name);
+    if (filePrefix.empty()) {
+        std::cout << "Failed to load any textures for PBR set: " << name << std::endl;
+        return;
     }
+    std::string prefix = basePath + "/" + filePrefix;
+
+    std::vector<std::pair<std::string, std::string>> textureTypes = {
+        {"albedo", filePrefix + "_Color.jpg"},
+        {"normal", filePrefix + "_NormalGL.jpg"}
+    };
 
+    // Baked block-compressed textures load directly; only the rest go to the decoder
+    std::vector<std::pair<std::string, std::string>> toDecode;
     for (const auto& pair : textureTypes) {
         const std::string& type = pair.first;
         const std::string& filename = pair.second;
-        std::string fullPath = basePath + "/" + filename;
-        unsigned int texID = loadTextureFromFile(fullPath);
+        unsigned int texID = loadCompressedTexture(basePath + "/" + filename);
         if (texID != 0) {
-            textureSet[type] = texID;
-            std::cout << "  Loaded " << type << " map: " << filename << std::endl;
+            pbrTextures[name][type] = texID;
+            std::cout << "  Loaded " << type << " map: " << filename << " (compressed)" << std::endl;
+        }
+        else {
+            toDecode.push_back(pair);
+        }
+    }
+
+    unsigned int ormID = loadPackedORM(prefix);
+    if (ormID != 0) {
+        pbrTextures[name]["orm"] = ormID;
+        std::cout << "  Loaded orm map: " << filePrefix << "_ORM.dds (compressed)" << std::endl;
+    }
+
+    size_t pending = toDecode.size() + (ormID == 0 ? 1 : 0);
+    if (pending == 0) {
+        reportPBRTextureSet(name);
+        return;
+    }
+
+    // Shared by the set's callbacks so the last one to arrive can report the result
+    auto remaining = std::make_shared<size_t>(pending);
+
+    for (const auto& pair : toDecode) {
+        std::string type = pair.first;
+        std::string filename = pair.second;
+        std::string fullPath = basePath + "/" + filename;
+
+        loader.request(fullPath, true, [this, name, type, filename, remaining](const DecodedImage& image) {
+            unsigned int texID = createTexture(image);
+            if (texID != 0) {
+                pbrTextures[name][type] = texID;
+                std::cout << "  Loaded " << type << " map: " << filename << std::endl;
+            }
+
+            if (--*remaining == 0) {
+                reportPBRTextureSet(name);
+            }
+        });
+    }
+
+    if (ormID == 0) {
+        // No current bake: decode the three maps and pack them here once all have arrived
+        auto sources = std::make_shared<std::vector<ORMSource>>(ORMChannel_Count);
+        auto received = std::make_shared<int>(0);
+
+        for (int channel = 0; channel < ORMChannel_Count; channel++) {
+            std::string sourcePath = getORMSourcePath(prefix, static_cast<ORMChannel>(channel));
+
+            loader.request(sourcePath, true, [this, name, channel, sources, received, remaining](const DecodedImage& image) {
+                (*sources)[channel] = makeORMSource(image.pixels, image.width, image.height, image.channels);
+                if (++*received < ORMChannel_Count) return;
+
+                std::vector<unsigned char> packed;
+                DecodedImage ormImage;
+                ormImage.path = name + " ORM (packed at load)";
+                if (packORM(sources->data(), packed, ormImage.width, ormImage.height)) {
+                    ormImage.pixels = packed.data();
+                    ormImage.channels = 3;
+                }
+                sources->clear();
+
+                unsigned int texID = createTexture(ormImage);
+                if (texID != 0) {
+                    pbrTextures[name]["orm"] = texID;
+                    std::cout << "  Packed orm map for " << name << std::endl;
+                }
+
+                if (--*remaining == 0) {
+                    reportPBRTextureSet(name);
+                }
+            });
+        }
+    }
+}
+
+unsigned int TextureManager::loadPackedORM(const std::string& prefix) {
+    std::string cachePath = getORMCachePath(prefix);
+    for (int channel = 0; channel < ORMChannel_Count; channel++) {
+        if (!isDDSCacheCurrent(getORMSourcePath(prefix, static_cast<ORMChannel>(channel)), cachePath)) {
+            return 0;
         }
     }
+    return loadDDSTexture(cachePath);
+}
 
-    if (!textureSet.empty()) {
-        pbrTextures[name] = textureSet;
+void TextureManager::reportPBRTextureSet(const std::string& name) {
+    if (hasPBRTextureSet(name)) {
         std::cout << "Successfully loaded PBR texture set: " << name << std::endl;
     }
     else {
@@ -153,7 +298,188 @@ void TextureManager::loadPBRTextureSet(const std::string& name, const std::strin
 }
 
 bool TextureManager::hasPBRTextureSet(const std::string& name) {
-    return pbrTextures.find(name) != pbrTextures.end();
+    return pbrTextures.find(name) != pbrTextures.end() || getPBRArrayLayer(name) >= 0;
+}
+
+unsigned int TextureManager::buildTextureArray(const std::vector<unsigned int>& sources, const unsigned char fill[4]) {
+    struct SourceInfo {
+        GLint width = 0, height = 0, compressed = 0, internalFormat = 0, levels = 0;
+    };
+
+    // Inspect the 2D sources: matching compressed layers can be copied block for block
+    std::vector<SourceInfo> info(sources.size());
+    GLint width = 0, height = 0;
+    bool anyPresent = false;
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (sources[i] == 0) continue;
+        anyPresent = true;
+
+        SourceInfo& source = info[i];
+        GLint maxLevel = 0;
+        glBindTexture(GL_TEXTURE_2D, sources[i]);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &source.width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &source.height);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &source.compressed);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &source.internalFormat);
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+        source.levels = std::min(getFullMipCount(source.width, source.height), maxLevel + 1);
+
+        width = std::max(width, source.width);
+        height = std::max(height, source.height);
+    }
+    if (sources.empty()) return 0;
+
+    // Nothing to copy: every layer becomes a 1x1 fill
+    if (!anyPresent) {
+        width = 1;
+        height = 1;
+    }
+
+    bool copyCompressed = true;
+    for (size_t i = 0; i < sources.size(); i++) {
+        const SourceInfo& source = info[i];
+        copyCompressed = copyCompressed && sources[i] != 0 && source.compressed &&
+            source.internalFormat == info[0].internalFormat && source.width == info[0].width &&
+            source.height == info[0].height && source.levels == info[0].levels;
+    }
+
+    GLsizei layers = static_cast<GLsizei>(sources.size());
+    unsigned int arrayID = 0;
+    glGenTextures(1, &arrayID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+    setMaterialSampling(GL_TEXTURE_2D_ARRAY);
+
+    std::vector<unsigned char> buffer;
+    if (copyCompressed) {
+        // Read each baked level back and copy it into its layer, keeping the compression
+        GLenum format = static_cast<GLenum>(info[0].internalFormat);
+        for (GLint level = 0; level < info[0].levels; level++) {
+            GLint levelWidth = std::max(width >> level, 1);
+            GLint levelHeight = std::max(height >> level, 1);
+            GLint levelSize = 0;
+            glBindTexture(GL_TEXTURE_2D, sources[0]);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &levelSize);
+
+            glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, levelWidth, levelHeight, layers, 0,
+                levelSize * layers, nullptr);
+
+            buffer.resize(levelSize);
+            for (GLsizei layer = 0; layer < layers; layer++) {
+                glBindTexture(GL_TEXTURE_2D, sources[layer]);
+                glGetCompressedTexImage(GL_TEXTURE_2D, level, buffer.data());
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, levelWidth, levelHeight, 1,
+                    format, levelSize, buffer.data());
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, info[0].levels - 1);
+    }
+    else {
+        // Mixed sources: expand everything to RGBA8 at the largest size and rebuild the mips
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        std::vector<unsigned char> layerPixels(static_cast<size_t>(width) * height * 4);
+        for (GLsizei layer = 0; layer < layers; layer++) {
+            const SourceInfo& source = info[layer];
+            if (sources[layer] == 0) {
+                for (size_t p = 0; p < layerPixels.size(); p += 4) {
+                    std::copy(fill, fill + 4, layerPixels.begin() + p);
+                }
+            }
+            else {
+                buffer.resize(static_cast<size_t>(source.width) * source.height * 4);
+                glBindTexture(GL_TEXTURE_2D, sources[layer]);
+                glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.data());
+
+                for (GLint y = 0; y < height; y++) {
+                    GLint sy = y * source.height / height;
+                    for (GLint x = 0; x < width; x++) {
+                        GLint sx = x * source.width / width;
+                        std::copy_n(&buffer[(static_cast<size_t>(sy) * source.width + sx) * 4], 4,
+                            &layerPixels[(static_cast<size_t>(y) * width + x) * 4]);
+                    }
+                }
+            }
+
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layerPixels.data());
+        }
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return arrayID;
+}
+
+bool TextureManager::buildPBRTextureArrays(const std::vector<std::string>& setNames) {
+    if (setNames.empty()) return false;
+
+    std::unordered_map<std::string, unsigned int> arrays;
+    for (int t = 0; t < PBR_MAP_TYPES; t++) {
+        std::vector<unsigned int> sources;
+        bool anyLoaded = false;
+        for (const std::string& name : setNames) {
+            sources.push_back(getPBRTexture(name, pbrMapTypes[t]));
+            anyLoaded = anyLoaded || sources.back() != 0;
+        }
+
+        if (!anyLoaded) {
+            std::cout << "No " << pbrMapTypes[t] << " maps loaded, using a 1x1 stand-in for every layer" << std::endl;
+        }
+        arrays[pbrMapTypes[t]] = buildTextureArray(sources, pbrStandInFills[t]);
+    }
+
+    for (auto& entry : pbrArrays) glDeleteTextures(1, &entry.second);
+    pbrArrays = arrays;
+    pbrArrayLayers = setNames;
+
+    // The arrays hold copies, so the per-set 2D textures can go
+    for (const std::string& name : setNames) {
+        auto it = pbrTextures.find(name);
+        if (it == pbrTextures.end()) continue;
+        for (auto& entry : it->second) glDeleteTextures(1, &entry.second);
+        pbrTextures.erase(it);
+    }
+
+    std::cout << "Built PBR texture arrays with " << setNames.size() << " layers" << std::endl;
+    return true;
+}
+
+unsigned int TextureManager::getPBRStandInArray(const std::string& type) {
+    auto it = pbrStandIns.find(type);
+    if (it != pbrStandIns.end()) return it->second;
+
+    for (int t = 0; t < PBR_MAP_TYPES; t++) {
+        if (type != pbrMapTypes[t]) continue;
+
+        unsigned int arrayID = buildTextureArray(std::vector<unsigned int>(1, 0), pbrStandInFills[t]);
+        pbrStandIns[type] = arrayID;
+        return arrayID;
+    }
+    return 0;
+}
+
+unsigned int TextureManager::getPBRTextureArray(const std::string& type) {
+    auto it = pbrArrays.find(type);
+    return it != pbrArrays.end() ? it->second : 0;
+}
+
+int TextureManager::getPBRArrayLayer(const std::string& name) {
+    for (size_t layer = 0; layer < pbrArrayLayers.size(); layer++) {
+        if (pbrArrayLayers[layer] == name) return static_cast<int>(layer);
+    }
+    return -1;
+}
+
+unsigned int TextureManager::getPBRTexture(const std::string& name, const std::string& type) {
+    auto it = pbrTextures.find(name);
+    if (it != pbrTextures.end()) {
+        auto typeIt = it->second.find(type);
+        if (typeIt != it->second.end()) {
+            return typeIt->second;
+        }
+    }
+    return 0;
 }
 
 void TextureManager::bindPBRTextures(const std::string& name, GLuint startUnit) {
@@ -170,13 +496,9 @@ void TextureManager::bindPBRTextures(const std::string& name, GLuint startUnit)
             glActiveTexture(GL_TEXTURE0 + unit++);
             glBindTexture(GL_TEXTURE_2D, textureSet.at("normal"));
         }
-        if (textureSet.find("roughness") != textureSet.end()) {
-            glActiveTexture(GL_TEXTURE0 + unit++);
-            glBindTexture(GL_TEXTURE_2D, textureSet.at("roughness"));
-        }
-        if (textureSet.find("ao") != textureSet.end()) {
+        if (textureSet.find("orm") != textureSet.end()) {
             glActiveTexture(GL_TEXTURE0 + unit++);
-            glBindTexture(GL_TEXTURE_2D, textureSet.at("ao"));
+            glBindTexture(GL_TEXTURE_2D, textureSet.at("orm"));
         }
     }
 }
@@ -0,0 +1,306 @@
+#include "HeightmapCache.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const uint32_t REGION_MAGIC = 0x43524854;  // "THRC"
+    // Bump when the stored heights would change for the same parameters
+    const uint32_t REGION_VERSION = 2;
+    const size_t HEADER_BYTES = 16;
+
+    const int REGION_CHUNKS = HeightmapCache::REGION_SIZE * HeightmapCache::REGION_SIZE;
+    const size_t CHECKSUM_BYTES = REGION_CHUNKS * sizeof(uint32_t);
+
+    // Touched each time a key's cache opens; its age orders the directories
+    const char* LAST_USED_FILE = "last-used";
+
+    // FNV-1a over the raw bytes of each field
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Folded to 32 bits and never zero, which marks an absent slot
+    uint32_t checksumHeights(const void* data, size_t size) {
+        uint64_t hash = hashBytes(14695981039346656037ull, data, size);
+        uint32_t checksum = static_cast<uint32_t>(hash ^ (hash >> 32));
+        return checksum ? checksum : 1;
+    }
+
+    bool makeDirectory(const std::string& path) {
+#ifdef _WIN32
+        return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+        return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+    }
+
+    // Names in a directory, without "." and ".."
+    std::vector<std::string> listDirectory(const std::string& path) {
+        std::vector<std::string> names;
+#ifdef _WIN32
+        WIN32_FIND_DATAA entry;
+        HANDLE find = FindFirstFileA((path + "/*").c_str(), &entry);
+        if (find == INVALID_HANDLE_VALUE) return names;
+        do {
+            names.push_back(entry.cFileName);
+        } while (FindNextFileA(find, &entry));
+        FindClose(find);
+#else
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return names;
+        while (dirent* entry = readdir(dir)) {
+            names.push_back(entry->d_name);
+        }
+        closedir(dir);
+#endif
+        names.erase(std::remove_if(names.begin(), names.end(), [](const std::string& name) {
+            return name == "." || name == "..";
+        }), names.end());
+        return names;
+    }
+
+    // Deletes a key directory and the region files in it
+    void removeCacheDirectory(const std::string& path) {
+        for (const std::string& name : listDirectory(path)) {
+            std::remove((path + "/" + name).c_str());
+        }
+#ifdef _WIN32
+        RemoveDirectoryA(path.c_str());
+#else
+        rmdir(path.c_str());
+#endif
+    }
+
+    // Modification time, or 0 if the file is missing
+    long long getModifiedTime(const std::string& path) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return 0;
+        return static_cast<long long>(info.st_mtime);
+    }
+
+    int floorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // Chunk's index within its region, row-major
+    int getRegionSlot(int chunkX, int chunkZ) {
+        const int size = HeightmapCache::REGION_SIZE;
+        return (chunkZ - floorDiv(chunkZ, size) * size) * size + (chunkX - floorDiv(chunkX, size) * size);
+    }
+}
+
+// One region file, mapped read-write while it is in use
+class HeightmapCache::Region {
+public:
+    Region(const std::string& path, int apronLength)
+        : slotBytes(static_cast<size_t>(apronLength) * apronLength * sizeof(float))
+    {
+        fileBytes = HEADER_BYTES + CHECKSUM_BYTES + REGION_CHUNKS * slotBytes;
+        if (!map(path)) {
+            std::cout << "Heightmap cache disabled for " << path << std::endl;
+            return;
+        }
+
+        // A fresh (zero-filled) file, or one written with another layout, starts empty
+        uint32_t* header = reinterpret_cast<uint32_t*>(data);
+        if (header[0] != REGION_MAGIC || header[1] != REGION_VERSION || header[2] != static_cast<uint32_t>(apronLength)
+            || header[3] != static_cast<uint32_t>(REGION_SIZE)) {
+            std::memset(data + HEADER_BYTES, 0, CHECKSUM_BYTES);
+            header[0] = REGION_MAGIC;
+            header[1] = REGION_VERSION;
+            header[2] = static_cast<uint32_t>(apronLength);
+            header[3] = static_cast<uint32_t>(REGION_SIZE);
+        }
+    }
+
+    ~Region() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(data, fileBytes);
+        if (file >= 0) close(file);
+#endif
+    }
+
+    Region(const Region&) = delete;
+    Region& operator=(const Region&) = delete;
+
+    bool isMapped() const { return data != nullptr; }
+
+    uint32_t* checksum(int slot) { return reinterpret_cast<uint32_t*>(data + HEADER_BYTES) + slot; }
+    float* heights(int slot) {
+        return reinterpret_cast<float*>(data + HEADER_BYTES + CHECKSUM_BYTES + slot * slotBytes);
+    }
+    size_t getSlotBytes() const { return slotBytes; }
+
+    // Guards the checksums and slots against a concurrent load and store
+    std::mutex mutex;
+
+private:
+    bool map(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        // Mapping a larger size grows the file, zero-filled
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(fileBytes);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+        if (!mapping) return false;
+
+        data = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, fileBytes));
+        return data != nullptr;
+#else
+        file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (file < 0) return false;
+
+        // Growing with ftruncate leaves the new range sparse and zero-filled
+        struct stat info;
+        if (fstat(file, &info) != 0) return false;
+        if (static_cast<size_t>(info.st_size) < fileBytes && ftruncate(file, static_cast<off_t>(fileBytes)) != 0) {
+            return false;
+        }
+
+        void* mapped = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        if (mapped == MAP_FAILED) return false;
+        data = static_cast<unsigned char*>(mapped);
+        return true;
+#endif
+    }
+
+    size_t slotBytes;
+    size_t fileBytes;
+    unsigned char* data = nullptr;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int file = -1;
+#endif
+};
+
+HeightmapCache::HeightmapCache(int seed, float noiseFreq, float noiseAmp, int chunkSize)
+    : seed(seed), noiseFreq(noiseFreq), noiseAmp(noiseAmp), chunkSize(chunkSize),
+    apronLength(chunkSize + 3)
+{
+    uint64_t key = 14695981039346656037ull;
+    key = hashBytes(key, &REGION_VERSION, sizeof(REGION_VERSION));
+    key = hashBytes(key, &seed, sizeof(seed));
+    key = hashBytes(key, &noiseFreq, sizeof(noiseFreq));
+    key = hashBytes(key, &noiseAmp, sizeof(noiseAmp));
+    key = hashBytes(key, &chunkSize, sizeof(chunkSize));
+
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    directory = std::string("Cache/Heightmaps/") + name;
+
+    directoryReady = makeDirectory("Cache") && makeDirectory("Cache/Heightmaps") && makeDirectory(directory);
+    if (!directoryReady) {
+        std::cout << "Heightmap cache disabled: can't create " << directory << std::endl;
+        return;
+    }
+    removeStaleDirectories();
+}
+
+void HeightmapCache::removeStaleDirectories() {
+    if (FILE* marker = std::fopen((directory + "/" + LAST_USED_FILE).c_str(), "w")) {
+        std::fputs("1", marker);
+        std::fclose(marker);
+    }
+
+    // Newest first; directories from before the marker existed sort last
+    std::vector<std::pair<long long, std::string>> keys;
+    for (const std::string& name : listDirectory("Cache/Heightmaps")) {
+        std::string path = std::string("Cache/Heightmaps/") + name;
+        if (path == directory) continue;
+        keys.emplace_back(getModifiedTime(path + "/" + LAST_USED_FILE), path);
+    }
+    std::sort(keys.begin(), keys.end(), [](const std::pair<long long, std::string>& a,
+        const std::pair<long long, std::string>& b) { return a.first > b.first; });
+
+    for (size_t i = MAX_DIRECTORIES - 1; i < keys.size(); i++) {
+        removeCacheDirectory(keys[i].second);
+    }
+}
+
+HeightmapCache::~HeightmapCache() = default;
+
+bool HeightmapCache::matches(int seed, float noiseFreq, float noiseAmp, int chunkSize) const {
+    return this->seed == seed && this->noiseFreq == noiseFreq && this->noiseAmp == noiseAmp
+        && this->chunkSize == chunkSize;
+}
+
+std::shared_ptr<HeightmapCache::Region> HeightmapCache::getRegion(int chunkX, int chunkZ) {
+    if (!directoryReady) return nullptr;
+
+    int regionX = floorDiv(chunkX, REGION_SIZE);
+    int regionZ = floorDiv(chunkZ, REGION_SIZE);
+    long long key = (static_cast<long long>(regionX) << 32) | static_cast<unsigned int>(regionZ);
+
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto found = regions.find(key);
+    if (found == regions.end()) {
+        // Unmap the least recently used region; workers still using it keep it alive
+        if (regions.size() >= MAX_MAPPED_REGIONS) {
+            auto oldest = regions.begin();
+            for (auto it = regions.begin(); it != regions.end(); ++it) {
+                if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+            }
+            regions.erase(oldest);
+        }
+
+        std::string path = directory + "/r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".bin";
+        MappedRegion mapped = { std::make_shared<Region>(path, apronLength), 0 };
+        found = regions.emplace(key, std::move(mapped)).first;
+    }
+    found->second.lastUsed = ++regionUses;
+    return found->second.region->isMapped() ? found->second.region : nullptr;
+}
+
+bool HeightmapCache::load(int chunkX, int chunkZ, float* out) {
+    std::shared_ptr<Region> region = getRegion(chunkX, chunkZ);
+    if (!region) return false;
+
+    int slot = getRegionSlot(chunkX, chunkZ);
+    std::lock_guard<std::mutex> lock(region->mutex);
+    uint32_t expected = *region->checksum(slot);
+    if (expected == 0) return false;
+
+    std::memcpy(out, region->heights(slot), region->getSlotBytes());
+    return checksumHeights(out, region->getSlotBytes()) == expected;
+}
+
+void HeightmapCache::store(int chunkX, int chunkZ, const float* heights) {
+    std::shared_ptr<Region> region = getRegion(chunkX, chunkZ);
+    if (!region) return;
+
+    int slot = getRegionSlot(chunkX, chunkZ);
+    std::lock_guard<std::mutex> lock(region->mutex);
+    std::memcpy(region->heights(slot), heights, region->getSlotBytes());
+    *region->checksum(slot) = checksumHeights(heights, region->getSlotBytes());
+}
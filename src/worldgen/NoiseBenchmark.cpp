@@ -0,0 +1,54 @@
+#include "NoiseBenchmark.h"
+#include "TerrainNoise.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+int runNoiseBenchmark() {
+    const int gridSize = 33;          // one 32-unit chunk
+    const float coordScale = 0.7f;    // TerrainManager::noiseFreq
+    const double minSeconds = 0.5;
+    const float tolerance = 1e-5f;
+
+    std::vector<float> samples(gridSize * gridSize);
+    double referenceRate = 0.0;
+    int exitCode = 0;
+
+    std::cout << "Noise benchmark: " << gridSize << "x" << gridSize << " grids, 1 thread" << std::endl;
+
+    TerrainNoise::Backend best = TerrainNoise::getBestBackend();
+    for (int b = TerrainNoise::Backend_Reference; b <= best; b++) {
+        TerrainNoise noise;
+        noise.setBackend(static_cast<TerrainNoise::Backend>(b));
+
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        long long grids = 0;
+        float checksum = 0.0f;
+
+        // Walk across chunks so every batch sees new lattice cells
+        while (elapsed < minSeconds) {
+            for (int i = 0; i < 64; i++, grids++) {
+                int chunk = static_cast<int>(grids % 4096);
+                noise.evaluateGrid((chunk % 64 - 32) * 32, (chunk / 64 - 32) * 32, gridSize, gridSize, coordScale, samples.data());
+                checksum += samples[grids % samples.size()];
+            }
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        double rate = grids * gridSize * gridSize / elapsed;
+        if (b == TerrainNoise::Backend_Reference) referenceRate = rate;
+
+        float maxError = noise.measureMaxError(coordScale);
+        if (maxError > tolerance) exitCode = 1;
+
+        std::cout << "  " << TerrainNoise::getBackendName(noise.getBackend()) << ": "
+            << rate / 1.0e6 << " M samples/s/core"
+            << " (x" << rate / referenceRate << " vs FastNoiseLite)"
+            << ", max error " << maxError
+            << (maxError > tolerance ? " OUT OF TOLERANCE" : "")
+            << " [checksum " << checksum << "]" << std::endl;
+    }
+
+    return exitCode;
+}
@@ -1,166 +1,181 @@
 #include "TerrainChunk.h"
-#include "TextureManager.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-#include "Camera.h"
+#include "HeightmapCache.h"
+#include "TerrainNormals.h"
+#include "TerrainVertexArena.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
-TerrainChunk::TerrainChunk(int chunkX, int chunkZ, int size, float noiseFreq, float noiseAmp)
-    : chunkX(chunkX), chunkZ(chunkZ), size(size), noiseFreq(noiseFreq), noiseAmp(noiseAmp),
-    shader("Assets/Shaders/terrain.vert", "Assets/Shaders/terrain.frag")
-{
-    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    noise.SetFractalType(FastNoiseLite::FractalType_None);  // Add fractal for more detail
+namespace {
 
+    float smoothstep(float edge0, float edge1, float x) {
+        float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
 
-    model = glm::translate(glm::mat4(1.0f), glm::vec3(chunkX * size, 0, chunkZ * size));
+    // Height bands blended as terrain.frag used to, then overridden by slope
+    void computeMaterialWeights(float height, float slope, const TerrainMaterialRules& rules,
+        unsigned char weights[4]) {
+        float range = rules.blendRange;
+        float aboveSand = smoothstep(rules.sandHeight - range, rules.sandHeight + range, height);
+        float aboveRock = smoothstep(rules.rockHeight - range, rules.rockHeight + range, height);
+        float aboveSnow = smoothstep(rules.snowHeight - range, rules.snowHeight + range, height);
+
+        float w[4] = {
+            1.0f - aboveSand,
+            aboveSand * (1.0f - aboveRock),
+            aboveRock * (1.0f - aboveSnow),
+            aboveSnow
+        };
+
+        float total = w[0] + w[1] + w[2] + w[3];
+        if (total > 0.0f) {
+            for (float& weight : w) weight /= total;
+        }
 
-    generateHeightmap();
-    setupMesh();
+        // Steep faces turn to rock whatever their height
+        float steep = smoothstep(rules.rockSlopeStart, rules.rockSlopeEnd, slope);
+        for (float& weight : w) weight *= 1.0f - steep;
+        w[2] += steep;
+
+        // Round to bytes, giving the rounding error to the largest weight so the sum stays 255
+        int sum = 0;
+        int largest = 0;
+        for (int i = 0; i < 4; i++) {
+            weights[i] = static_cast<unsigned char>(w[i] * 255.0f + 0.5f);
+            sum += weights[i];
+            if (w[i] > w[largest]) largest = i;
+        }
+        weights[largest] = static_cast<unsigned char>(weights[largest] + 255 - sum);
+    }
 }
 
-void TerrainChunk::generateHeightmap() {
-    vertices.clear();
-    heights.clear();
-    indices.clear();
+TerrainChunk::TerrainChunk(ChunkMeshData&& data, TerrainVertexArena& arena)
+    : chunkX(data.chunkX), chunkZ(data.chunkZ), size(data.size),
+    arena(arena),
+    heights(std::move(data.heights)),
+    minHeight(data.minHeight), maxHeight(data.maxHeight), layerMask(data.layerMask)
+{
+    offset = glm::vec3(chunkX * size, 0, chunkZ * size);
 
-    float texScale = 1.0f / size;
+    arena.allocate(slot, data.vertices, offset, data.heightBase, data.heightRange);
+    gpuBytes = arena.getSlotFootprint();
 
-    for (int z = 0; z <= size; z++) {
-        for (int x = 0; x <= size; x++) {
-            float worldX = (chunkX * size) + x;
-            float worldZ = (chunkZ * size) + z;
+    // The GPU owns the mesh now; drop the CPU copy
+    std::vector<TerrainVertex>().swap(data.vertices);
+}
 
-            // Get noise value
-            float height = noise.GetNoise(worldX * noiseFreq, worldZ * noiseFreq) * noiseAmp;
+TerrainChunk::~TerrainChunk() {
+    arena.release(slot);
+}
 
+void TerrainChunk::generateHeightmap(ChunkMeshData& data, int noiseSeed, float noiseFreq, float noiseAmp,
+    TerrainNoise::Backend noiseBackend, const TerrainMaterialRules& materialRules,
+    HeightmapCache* heightmapCache) {
+    const int size = data.size;
+    const int rowLength = size + 1;
+    std::vector<TerrainVertex>& vertices = data.vertices;
+    std::vector<float>& heights = data.heights;
+
+    // Whole grid plus a one-vertex apron. The apron gives border vertices the same
+    // central differences their neighbour chunk computes, so normals and slopes match
+    // across chunk edges.
+    const int apronLength = rowLength + 2;
+    std::vector<float> apron(apronLength * apronLength);
+
+    data.fromCache = heightmapCache && heightmapCache->load(data.chunkX, data.chunkZ, apron.data());
+    if (!data.fromCache) {
+        // One noise instance per call so worker threads never share state
+        TerrainNoise noise(noiseSeed);
+        noise.setBackend(noiseBackend);
+
+        // One batched call, straight into the preallocated buffer
+        noise.evaluateGrid(data.chunkX * size - 1, data.chunkZ * size - 1, apronLength, apronLength, noiseFreq, apron.data());
+
+        for (float& height : apron) {
+            height = height * noiseAmp;
             height = height * noiseAmp;  // This gives range [-noiseAmp, noiseAmp]
-
-            // Store height for this vertex
-            heights.push_back(height);
-
-            // Vertex position
-            vertices.push_back(static_cast<float>(x));
-            vertices.push_back(height);
-            vertices.push_back(static_cast<float>(z));
-
-            // Texture coordinates (scale for more repetition)
-            vertices.push_back(static_cast<float>(x) * texScale * 2.0f);
-            vertices.push_back(static_cast<float>(z) * texScale * 2.0f);
         }
-    }
 
-    // Indices
-    for (int z = 0; z < size; z++) {
-        for (int x = 0; x < size; x++) {
-            int topLeft = z * (size + 1) + x;
-            int topRight = topLeft + 1;
-            int bottomLeft = (z + 1) * (size + 1) + x;
-            int bottomRight = bottomLeft + 1;
-
-            indices.push_back(topLeft);
-            indices.push_back(bottomLeft);
-            indices.push_back(topRight);
-
-            indices.push_back(topRight);
-            indices.push_back(bottomLeft);
-            indices.push_back(bottomRight);
+        if (heightmapCache) {
+            heightmapCache->store(data.chunkX, data.chunkZ, apron.data());
         }
     }
-}
-
-void TerrainChunk::setupMesh() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
+    data.minHeight = std::numeric_limits<float>::max();
+    data.maxHeight = std::numeric_limits<float>::lowest();
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER,
-        vertices.size() * sizeof(float),
-        vertices.data(),
-        GL_STATIC_DRAW);
+    heights.resize(rowLength * rowLength);
+    for (int z = 0; z <= size; z++) {
+        const float* apronRow = &apron[(z + 1) * apronLength + 1];
+        for (int x = 0; x <= size; x++) {
+            heights[z * rowLength + x] = apronRow[x];
+            data.minHeight = std::min(data.minHeight, apronRow[x]);
+            data.maxHeight = std::max(data.maxHeight, apronRow[x]);
+        }
+    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        indices.size() * sizeof(unsigned int),
-        indices.data(),
-        GL_STATIC_DRAW);
+    vertices.resize(TerrainIndexBuffer::getVertexCount(size));
+    TerrainVertex* vertex = vertices.data();
 
-    // Vertex attribute - position (x y z)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-        5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    // Heights are stored as unorm16 over the chunk's range, skirt included. That is
+    // about 2 mm of precision across the default terrain's height span.
+    float skirtHeight = data.minHeight - 1.0f;
+    data.heightBase = skirtHeight;
+    data.heightRange = data.maxHeight - skirtHeight;
+    float heightToUnorm = 65535.0f / data.heightRange;
 
-    // Vertex attribute - texture coordinates (u v)
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
-        5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    data.layerMask = 0;
+    std::vector<int16_t> rowNormals(2 * rowLength);
 
-    glBindVertexArray(0);
-}
+    for (int z = 0; z <= size; z++) {
+        const float* row = &apron[(z + 1) * apronLength + 1];
+        const float* above = row - apronLength;
+        const float* below = row + apronLength;
+        encodeNormalRow(above, row, below, rowLength, rowNormals.data());
 
-void TerrainChunk::draw(Camera camera) {
-    shader.use();
-
-    TextureManager& texManager = TextureManager::getInstance();
-
-    bool hasSandPBR = texManager.hasPBRTextureSet("sand");
-    bool hasGrassPBR = texManager.hasPBRTextureSet("grass");
-    bool hasRockPBR = texManager.hasPBRTextureSet("rock");
-    bool hasSnowPBR = texManager.hasPBRTextureSet("snow");
-
-    if (hasSandPBR && hasGrassPBR && hasRockPBR && hasSnowPBR) {
-        texManager.bindPBRTextures("sand", 0);
-        texManager.bindPBRTextures("grass", 4);
-        texManager.bindPBRTextures("rock", 8);
-        texManager.bindPBRTextures("snow", 12);
-
-        shader.setInt("sandAlbedo", 0);
-        shader.setInt("sandNormal", 1);
-        shader.setInt("sandRoughness", 2);
-        shader.setInt("sandAO", 3);
-
-        shader.setInt("grassAlbedo", 4);
-        shader.setInt("grassNormal", 5);
-        shader.setInt("grassRoughness", 6);
-        shader.setInt("grassAO", 7);
-
-        shader.setInt("rockAlbedo", 8);
-        shader.setInt("rockNormal", 9);
-        shader.setInt("rockRoughness", 10);
-        shader.setInt("rockAO", 11);
-
-        shader.setInt("snowAlbedo", 12);
-        shader.setInt("snowNormal", 13);
-        shader.setInt("snowRoughness", 14);
-        shader.setInt("snowAO", 15);
-    }
-    else {
-        std::cout << "WARNING: Not all PBR textures loaded, using fallback" << std::endl;
-        texManager.bindTexture("fallback", 0);
-        shader.setInt("fallbackTexture", 0);
-    }
+        for (int x = 0; x <= size; x++) {
+            float height = row[x];
 
-    shader.setFloat("sandHeight", sandHeight);
-    shader.setFloat("grassHeight", grassHeight);
-    shader.setFloat("rockHeight", rockHeight);
-    shader.setFloat("snowHeight", snowHeight);
+            float dhdx = (row[x + 1] - row[x - 1]) * 0.5f;
+            float dhdz = (below[x] - above[x]) * 0.5f;
+            float slope = 1.0f - 1.0f / std::sqrt(dhdx * dhdx + dhdz * dhdz + 1.0f);
 
- 
-    shader.setVec3("lightPos", glm::vec3(500.0f, 1000.0f, 500.0f));
-    shader.setVec3("lightColor", glm::vec3(1.2f, 1.1f, 0.95f));
-    shader.setVec3("viewPos", camera.getCameraPos());
+            vertex->height = static_cast<uint16_t>(std::lrint((height - data.heightBase) * heightToUnorm));
+            vertex->padding = 0;
 
+            vertex->normal[0] = rowNormals[2 * x];
+            vertex->normal[1] = rowNormals[2 * x + 1];
 
-    shader.setMat4("projection", glm::value_ptr(camera.getProjectionMatrix()));
-    shader.setMat4("view", glm::value_ptr(camera.getViewMatrix()));
-    shader.setMat4("model", glm::value_ptr(this->model));
+            computeMaterialWeights(height, slope, materialRules, vertex->weights);
+            for (int band = 0; band < 4; band++) {
+                if (vertex->weights[band] > 0) data.layerMask |= 1u << band;
+            }
+            vertex++;
+        }
+    }
 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    // Skirt ring below the borders, in TerrainIndexBuffer's order: north, south, west, east.
+    // Dropping to the chunk's lowest point always covers the gap to a neighbour at another
+    // LOD, since both edges interpolate between the same border heights.
+    for (int side = 0; side < 4; side++) {
+        for (int i = 0; i <= size; i++) {
+            int x = (side == 0 || side == 1) ? i : (side == 2 ? 0 : size);
+            int z = (side == 2 || side == 3) ? i : (side == 0 ? 0 : size);
+
+            // Same normal and material as the border vertex above, so the skirt never shows a seam
+            *vertex = vertices[z * rowLength + x];
+            vertex->height = 0;
+            vertex++;
+        }
+    }
 }
 
+int TerrainChunk::getLodCount() const {
+    return arena.getIndexBuffer().getLodCount();
+}
 
+int TerrainChunk::addToBatch(TerrainDrawBatch& batch, int lodLevel) const {
+    return arena.addDraw(batch, slot, lodLevel);
+}
@@ -0,0 +1,11 @@
+#include "TerrainChunkGrid.h"
+#include <algorithm>
+
+TerrainChunkGrid::TerrainChunkGrid(int dimension) {
+    reset(dimension);
+}
+
+void TerrainChunkGrid::reset(int dimension) {
+    this->dimension = std::max(dimension, 1);
+    slots.assign(static_cast<size_t>(this->dimension) * this->dimension, ChunkSlot());
+}
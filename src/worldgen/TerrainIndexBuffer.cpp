@@ -0,0 +1,50 @@
+#include "TerrainIndexBuffer.h"
+#include <cstdint>
+#include "TerrainTopology.h"
+
+TerrainIndexBuffer::TerrainIndexBuffer(int size)
+    : size(size)
+{
+    glGenBuffers(1, &EBO);
+
+    if (getVertexCount(size) < 65536) {
+        indexType = GL_UNSIGNED_SHORT;
+        upload<uint16_t>(size);
+    }
+    else {
+        indexType = GL_UNSIGNED_INT;
+        upload<uint32_t>(size);
+    }
+}
+
+TerrainIndexBuffer::~TerrainIndexBuffer() {
+    glDeleteBuffers(1, &EBO);
+}
+
+template <typename IndexT>
+void TerrainIndexBuffer::upload(int size) {
+    // Triangles reordered for the post-transform cache; tools/MeshCacheReport measures the gain
+    std::vector<TerrainLodIndices> levels;
+    std::vector<uint32_t> source = buildTerrainIndices(size, MAX_LOD_LEVELS, true, levels);
+    std::vector<IndexT> indices(source.begin(), source.end());
+
+    for (const TerrainLodIndices& level : levels) {
+        LodRange lod;
+        lod.stride = level.stride;
+        lod.indexCount = static_cast<GLsizei>(level.indexCount);
+        lod.byteOffset = level.firstIndex * sizeof(IndexT);
+        lods.push_back(lod);
+    }
+
+    bytes = indices.size() * sizeof(IndexT);
+
+    // Unbind any VAO so creating this buffer doesn't alter a chunk's element binding
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, bytes, indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void TerrainIndexBuffer::bind() const {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+}
@@ -1,35 +1,656 @@
 #include "TerrainManager.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <string>
 #include "Shader.h"
+#include "ShaderManager.h"
+#include "TextureManager.h"
 #include "Camera.h"
 
 
+TerrainManager::TerrainManager()
+    : workerPool(new ThreadPool())
+{
+    std::cout << "Terrain generation: " << workerPool->size() << " worker threads" << std::endl;
+}
+
+void TerrainManager::selectNoiseBackend() {
+    // Checked at the settings chunks are generated with, so a change re-runs it
+    TerrainNoise noise(noiseSeed);
+    float maxError = noise.measureMaxError(noiseFreq);
+
+    if (maxError <= 1e-5f) {
+        noiseBackend = noise.getBackend();
+    }
+    else {
+        std::cout << "WARNING: Batched noise differs from FastNoiseLite by " << maxError
+            << ", falling back to per-sample noise" << std::endl;
+        noiseBackend = TerrainNoise::Backend_Reference;
+    }
+    std::cout << "Terrain noise backend: " << TerrainNoise::getBackendName(noiseBackend)
+        << " (seed " << noiseSeed << ", frequency " << noiseFreq << ")" << std::endl;
+
+    checkedNoiseSeed = noiseSeed;
+    checkedNoiseFreq = noiseFreq;
+    hasNoiseBackend = true;
+}
+
+TerrainManager::~TerrainManager() {
+    // Stop the workers before the completion queue goes away
+    workerPool.reset();
+    releaseChunks();
+}
+
+void TerrainManager::setupTerrainShaders() {
+    TextureManager& texManager = TextureManager::getInstance();
+
+    const char* bandSets[MATERIAL_BANDS] = { "sand", "grass", "rock", "snow" };
+    const char* maps[MATERIAL_MAPS] = { "albedo", "normal", "orm" };
+    const char* samplerNames[MATERIAL_MAPS] = { "materialAlbedo", "materialNormal", "materialORM" };
+
+    // main() copies the sets into texture arrays; each band just needs its layer index.
+    // Without them, every band samples layer 0 of the stand-in arrays.
+    bool hasPBRMaterial = true;
+    for (int map = 0; map < MATERIAL_MAPS; map++) {
+        materialTextures[map] = texManager.getPBRTextureArray(maps[map]);
+        if (materialTextures[map] == 0) {
+            materialTextures[map] = texManager.getPBRStandInArray(maps[map]);
+            hasPBRMaterial = false;
+        }
+    }
+
+    int bandLayers[MATERIAL_BANDS];
+    for (int band = 0; band < MATERIAL_BANDS; band++) {
+        bandLayers[band] = texManager.getPBRArrayLayer(bandSets[band]);
+        if (bandLayers[band] < 0 || !hasPBRMaterial) {
+            bandLayers[band] = 0;
+            hasPBRMaterial = false;
+        }
+    }
+
+    if (!hasPBRMaterial) {
+        std::cout << "WARNING: Not all PBR textures loaded, using stand-in materials" << std::endl;
+    }
+
+    // All permutations up front, so a new combination of bands never stalls a frame
+    for (int mask = 1; mask < MATERIAL_PERMUTATIONS; mask++) {
+        TerrainProgram& program = terrainPrograms[mask];
+        program.shader = ShaderManager::getInstance().getShader("Assets/Shaders/terrain.vert", "Assets/Shaders/terrain.frag",
+            "#define MATERIAL_LAYER_MASK " + std::to_string(mask) + "\n");
+        Shader& shader = *program.shader;
+
+        program.uniforms.projection = shader.getUniform("projection");
+        program.uniforms.view = shader.getUniform("view");
+        program.uniforms.viewPos = shader.getUniform("viewPos");
+        program.uniforms.lightPos = shader.getUniform("lightPos");
+        program.uniforms.lightColor = shader.getUniform("lightColor");
+        program.uniforms.arena.gridSize = shader.getUniform("gridSize");
+        program.uniforms.arena.slotVertices = shader.getUniform("slotVertices");
+
+        // Sampler units are program state, so they only need setting once
+        shader.use();
+        shader.setInt("chunkSlots", TerrainVertexArena::SLOT_TEXTURE_UNIT);
+        for (int map = 0; map < MATERIAL_MAPS; map++) {
+            shader.setInt(samplerNames[map], map);
+        }
+        shader.setIntArray(shader.getUniform("bandLayers"), bandLayers, MATERIAL_BANDS);
+    }
+}
+
+void TerrainManager::beginTerrainPass() {
+    if (!terrainPrograms[MATERIAL_PERMUTATIONS - 1].shader) {
+        setupTerrainShaders();
+    }
+
+    for (int unit = 0; unit < MATERIAL_MAPS; unit++) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, materialTextures[unit]);
+    }
+}
+
+void TerrainManager::bindTerrainProgram(unsigned int layerMask, const Camera& camera) {
+    TerrainProgram& program = terrainPrograms[layerMask];
+    Shader& shader = *program.shader;
+
+    shader.use();
+
+    shader.setVec3(program.uniforms.lightPos, glm::vec3(500.0f, 1000.0f, 500.0f));
+    shader.setVec3(program.uniforms.lightColor, glm::vec3(1.2f, 1.1f, 0.95f));
+    shader.setVec3(program.uniforms.viewPos, camera.getCameraPos());
+
+    shader.setMat4(program.uniforms.projection, glm::value_ptr(camera.getProjectionMatrix()));
+    shader.setMat4(program.uniforms.view, glm::value_ptr(camera.getViewMatrix()));
+}
+
+void TerrainManager::endTerrainPass() {
+    glBindVertexArray(0);
+    // Leave unit 0 active for the passes that follow, as they expect
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void TerrainManager::releaseChunks() {
+    for (ChunkSlot& slot : grid.getSlots()) {
+        if (slot.state == ChunkSlotState_Resident) {
+            destroyChunk(slot.chunk);
+        }
+        slot = ChunkSlot();
+    }
+    residentChunks = 0;
+
+    for (TerrainChunk* chunk : destroyQueue) {
+        destroyChunk(chunk);
+    }
+    destroyQueue.clear();
+    retiringMemory = 0;
+
+    // Results still on the workers find their slots empty and are dropped
+    uploadQueue.clear();
+    chunkRequests.clear();
+
+    for (auto& entry : arenas) {
+        gpuMemoryUsage -= entry.second->getIndexBuffer().getBytes();
+    }
+    arenas.clear();
+    updateAllocatedMemory();
+    for (TerrainProgram& program : terrainPrograms) {
+        program.shader.reset();
+    }
+}
+
+TerrainVertexArena& TerrainManager::getArena(int size) {
+    std::unique_ptr<TerrainVertexArena>& arena = arenas[size];
+    if (!arena) {
+        // Room for the visible square up front; the arena doubles if eviction lags behind
+        int visibleChunks = (2 * renderDistance + 1) * (2 * renderDistance + 1);
+        arena.reset(new TerrainVertexArena(size, visibleChunks));
+        gpuMemoryUsage += arena->getIndexBuffer().getBytes();
+        updateAllocatedMemory();
+    }
+    return *arena;
+}
+
+void TerrainManager::updateAllocatedMemory() {
+    // Everything the arenas have reserved, used or not: growth shows up here at once,
+    // and eviction only brings it down when an arena shrinks
+    allocatedGpuMemory = 0;
+    for (const auto& entry : arenas) {
+        allocatedGpuMemory += entry.second->getIndexBuffer().getBytes() + entry.second->getCapacityBytes();
+    }
+    peakMemoryUsage = std::max(peakMemoryUsage, getMemoryUsage());
+    peakAllocatedMemory = std::max(peakAllocatedMemory, getAllocatedMemoryUsage());
+}
+
+size_t TerrainManager::getMinimumMemoryBudget() const {
+    size_t bytes = 0;
+    for (const auto& entry : arenas) {
+        bytes += entry.second->getIndexBuffer().getBytes() + entry.second->getMinCapacityBytes();
+    }
+    return bytes;
+}
+
+void TerrainManager::destroyChunk(TerrainChunk* chunk) {
+    gpuMemoryUsage -= chunk->getGpuBytes();
+    cpuMemoryUsage -= chunk->getCpuBytes();
+    delete chunk;
+}
 
-long long TerrainManager::hash(int x, int z) {
-    return (((long long)x) << 32) | (unsigned int)z;
+int TerrainManager::getRequiredGridDimension() const {
+    // Resident chunks are kept out to the eviction distance, and prefetches reach up
+    // to twice the render distance (plus one) from the camera
+    int keepDistance = std::max(evictionDistance, renderDistance + 1);
+    int reach = std::max(keepDistance, 2 * renderDistance + 1);
+    return 2 * reach + 1;
 }
 
+void TerrainManager::retireChunk(ChunkSlot& slot) {
+    // Out of the grid now so it is never drawn again; freed within a later frame's budget
+    TerrainChunk* chunk = slot.chunk;
+    retiringMemory += chunk->getGpuBytes() + chunk->getCpuBytes();
+    destroyQueue.push_back(chunk);
+    residentChunks--;
+    evictedChunks++;
 
-void TerrainManager::update(Camera camera) {
+    if (slot.prefetched) {
+        prefetchWasted++;
+    }
+    slot = ChunkSlot();
+}
+
+bool TerrainManager::queueChunk(int cx, int cz, bool prefetch) {
+    ChunkSlot& slot = grid.at(cx, cz);
+    if (slot.holds(cx, cz)) return false;
+
+    // The slot's previous chunk is a full grid away from this one, so out of range
+    if (slot.state == ChunkSlotState_Resident) {
+        retireChunk(slot);
+    }
+
+    slot = ChunkSlot();
+    slot.chunkX = cx;
+    slot.chunkZ = cz;
+    slot.state = ChunkSlotState_Pending;
+    slot.prefetched = prefetch;
+
+    ChunkRequest request = { cx, cz, prefetch, 0.0f };
+    chunkRequests.push_back(request);
+    return true;
+}
+
+void TerrainManager::scheduleChunkRequests(const Camera& camera, const Frustum& frustum, int camChunkX, int camChunkZ) {
     glm::vec3 cameraPos = camera.getCameraPos();
-    glm::mat4 projection = camera.getProjectionMatrix();
-    glm::mat4 view = camera.getViewMatrix();
+    glm::vec2 position(cameraPos.x, cameraPos.z);
+    glm::vec3 front3 = camera.getCameraFront();
+    glm::vec2 front(front3.x, front3.z);
+    if (glm::length(front) > 1e-4f) {
+        front = glm::normalize(front);
+    }
+
+    // Heights aren't known before generation; every chunk lies within this band
+    float heightExtent = noiseAmp * noiseAmp * 2.0f;
+    int keepDistance = renderDistance + prefetchReach;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < chunkRequests.size(); i++) {
+        ChunkRequest request = chunkRequests[i];
+
+        // Another chunk took over the slot
+        ChunkSlot& slot = grid.at(request.chunkX, request.chunkZ);
+        if (!slot.holds(request.chunkX, request.chunkZ)) {
+            cancelledChunks++;
+            continue;
+        }
+
+        // The camera moved on before a worker got to it
+        int distance = std::max(std::abs(request.chunkX - camChunkX), std::abs(request.chunkZ - camChunkZ));
+        if (distance > keepDistance) {
+            slot = ChunkSlot();
+            cancelledChunks++;
+            continue;
+        }
+
+        glm::vec2 chunkMin(static_cast<float>(request.chunkX * chunkSize), static_cast<float>(request.chunkZ * chunkSize));
+        glm::vec2 toChunk = chunkMin + glm::vec2(chunkSize * 0.5f) - position;
+        float length = glm::length(toChunk);
+        float facing = length > 0.0f ? glm::dot(toChunk, front) / length : 1.0f;
+        bool visible = frustum.intersectsAABB(glm::vec3(chunkMin.x, -heightExtent, chunkMin.y),
+            glm::vec3(chunkMin.x + chunkSize, heightExtent, chunkMin.y + chunkSize));
+
+        // Distance in chunks, up to twice as far for chunks behind the camera and four
+        // times again outside the frustum; prefetches count as half as far
+        request.priority = length / chunkSize * (1.5f - 0.5f * facing);
+        if (!visible) request.priority *= 4.0f;
+        if (request.prefetch) request.priority *= 0.5f;
+
+        chunkRequests[kept++] = request;
+    }
+    chunkRequests.resize(kept);
+
+    // Enough to keep every worker busy between frames, and no more. Chunks waiting for
+    // upload count too, so generation doesn't run ahead of the upload budget.
+    size_t maxInFlight = workerPool->size() * 2;
+    if (chunksInFlight + uploadQueue.size() >= maxInFlight || chunkRequests.empty()) return;
+
+    // Best at the back, so dispatching pops
+    std::sort(chunkRequests.begin(), chunkRequests.end(),
+        [](const ChunkRequest& a, const ChunkRequest& b) { return a.priority > b.priority; });
+
+    while (chunksInFlight + uploadQueue.size() < maxInFlight && !chunkRequests.empty()) {
+        const ChunkRequest& request = chunkRequests.back();
+        requestChunk(request.chunkX, request.chunkZ);
+        chunkRequests.pop_back();
+        chunksInFlight++;
+    }
+}
+
+void TerrainManager::requestChunk(int cx, int cz) {
+    if (!hasNoiseBackend || checkedNoiseSeed != noiseSeed || checkedNoiseFreq != noiseFreq) {
+        selectNoiseBackend();
+    }
+
+    int size = chunkSize;
+    float freq = noiseFreq;
+    float amp = noiseAmp;
+    TerrainNoise::Backend backend = noiseBackend;
+    int seed = noiseSeed;
+    TerrainMaterialRules rules = materialRules;
+
+    std::shared_ptr<HeightmapCache> cache;
+    if (useHeightmapCache) {
+        if (!heightmapCache || !heightmapCache->matches(seed, freq, amp, size)) {
+            heightmapCache = std::make_shared<HeightmapCache>(seed, freq, amp, size);
+        }
+        cache = heightmapCache;
+    }
+
+    workerPool->submit([this, cx, cz, size, seed, freq, amp, backend, rules, cache]() {
+        ChunkMeshData data;
+        data.chunkX = cx;
+        data.chunkZ = cz;
+        data.size = size;
+
+        auto start = std::chrono::steady_clock::now();
+        TerrainChunk::generateHeightmap(data, seed, freq, amp, backend, rules, cache.get());
+        data.generationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completedChunks.push_back(std::move(data));
+    });
+}
+
+void TerrainManager::updateCameraVelocity(const glm::vec3& cameraPos, float deltaTime) {
+    if (hasLastCameraPos && deltaTime > 0.0f) {
+        glm::vec3 velocity = (cameraPos - lastCameraPos) / deltaTime;
+
+        // A jump of more than the render square is a teleport, not movement
+        if (glm::length(cameraPos - lastCameraPos) > static_cast<float>(renderDistance * chunkSize)) {
+            cameraVelocity = glm::vec3(0.0f);
+        }
+        else {
+            // Smoothed over a few frames so one uneven frame step doesn't swing the prediction
+            cameraVelocity = glm::mix(cameraVelocity, velocity, 0.25f);
+        }
+    }
+    lastCameraPos = cameraPos;
+    hasLastCameraPos = true;
+}
+
+void TerrainManager::prefetchChunks(int camChunkX, int camChunkZ) {
+    glm::vec2 position(lastCameraPos.x, lastCameraPos.z);
+    glm::vec2 velocity(cameraVelocity.x, cameraVelocity.z);
+    float speed = glm::length(velocity);
+
+    // Standing still (or nearly): the visible square already covers everything needed
+    prefetchReach = 0;
+    float lookahead = speed * prefetchSeconds;
+    if (lookahead < chunkSize * 0.5f) return;
+
+    // Further out than one square the prediction is mostly noise, and the chunks would
+    // likely be evicted before the camera gets there
+    lookahead = std::min(lookahead, static_cast<float>(renderDistance * chunkSize));
+    glm::vec2 heading = velocity / speed;
+
+    // Walk the path a chunk at a time; the square around each point covers what the
+    // camera will need on arrival
+    int steps = static_cast<int>(std::ceil(lookahead / chunkSize));
+    // One extra for the path point rounding down into its chunk
+    prefetchReach = steps + 1;
+    for (int step = 1; step <= steps; step++) {
+        glm::vec2 point = position + heading * std::min(step * static_cast<float>(chunkSize), lookahead);
+        int pointChunkX = static_cast<int>(std::floor(point.x / chunkSize));
+        int pointChunkZ = static_cast<int>(std::floor(point.y / chunkSize));
+
+        for (int dz = -renderDistance; dz <= renderDistance; dz++) {
+            for (int dx = -renderDistance; dx <= renderDistance; dx++) {
+                int cx = pointChunkX + dx;
+                int cz = pointChunkZ + dz;
+
+                // The current square is requested by update() itself
+                if (std::abs(cx - camChunkX) <= renderDistance && std::abs(cz - camChunkZ) <= renderDistance) {
+                    continue;
+                }
+
+                if (!queueChunk(cx, cz, true)) continue;
+                prefetchRequests++;
+            }
+        }
+    }
+}
+
+void TerrainManager::collectCompletedChunks() {
+    std::vector<ChunkMeshData> ready;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        ready.swap(completedChunks);
+    }
+
+    for (ChunkMeshData& data : ready) {
+        chunksInFlight--;
+
+        generatedChunks++;
+        if (data.fromCache) cachedChunks++;
+        chunkGenerationSeconds += data.generationSeconds;
+        maxChunkGenerationSeconds = std::max(maxChunkGenerationSeconds, data.generationSeconds);
+
+        uploadQueue.push_back(std::move(data));
+    }
+}
+
+void TerrainManager::uploadChunk(ChunkMeshData& data) {
+    // Dropped if the slot was recycled or released while the chunk was generating
+    ChunkSlot& slot = grid.at(data.chunkX, data.chunkZ);
+    if (!slot.holds(data.chunkX, data.chunkZ) || slot.state != ChunkSlotState_Pending) return;
+
+    // Only the buffer upload happens here; generation already ran on a worker
+    TerrainVertexArena& arena = getArena(data.size);
+    TerrainChunk* chunk = new TerrainChunk(std::move(data), arena);
+
+    slot.state = ChunkSlotState_Resident;
+    slot.chunk = chunk;
+    slot.boundsMin = chunk->getBoundsMin();
+    slot.boundsMax = chunk->getBoundsMax();
+    slot.layerMask = chunk->getLayerMask();
+    slot.lodCount = chunk->getLodCount();
+    slot.lastDrawnFrame = frameIndex;
+    residentChunks++;
+
+    gpuMemoryUsage += chunk->getGpuBytes();
+    cpuMemoryUsage += chunk->getCpuBytes();
+    // The allocation may have grown the arena
+    updateAllocatedMemory();
+}
+
+void TerrainManager::processMainThreadWork() {
+    auto start = std::chrono::steady_clock::now();
+    double budgetSeconds = mainThreadBudgetMs / 1000.0;
+    bool first = true;
+
+    auto withinBudget = [&]() {
+        // Always make some progress, however small the budget
+        if (first) {
+            first = false;
+            return true;
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < budgetSeconds;
+    };
+
+    // Destroys first: they free arena slots the uploads can reuse
+    bool destroyed = false;
+    while (!destroyQueue.empty() && withinBudget()) {
+        TerrainChunk* chunk = destroyQueue.back();
+        destroyQueue.pop_back();
+        retiringMemory -= chunk->getGpuBytes() + chunk->getCpuBytes();
+        destroyChunk(chunk);
+        destroyed = true;
+    }
+
+    while (!uploadQueue.empty() && withinBudget()) {
+        uploadChunk(uploadQueue.front());
+        uploadQueue.pop_front();
+    }
+
+    // After the uploads, so an arena never shrinks only to grow again in the same frame
+    if (destroyed) {
+        bool shrunk = false;
+        for (auto& entry : arenas) {
+            shrunk = entry.second->shrinkToFit() || shrunk;
+        }
+        if (shrunk) updateAllocatedMemory();
+    }
+
+    mainThreadWorkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int TerrainManager::selectLod(const ChunkSlot& slot, const glm::vec3& cameraPos) const {
+    // Distance from the camera to the closest point of the chunk's bounds
+    glm::vec3 closest = glm::clamp(cameraPos, slot.boundsMin, slot.boundsMax);
+    float distance = glm::length(cameraPos - closest);
+
+    int level = 0;
+    float threshold = lodDistance;
+    while (distance > threshold && level + 1 < slot.lodCount) {
+        level++;
+        threshold *= 2.0f;
+    }
+    return level;
+}
+
+void TerrainManager::evictChunks(int camChunkX, int camChunkZ) {
+    // Below the arenas' minimum footprint, evicting frees slots the driver never gets back
+    size_t budget = std::max(memoryBudget, getMinimumMemoryBudget());
+    if (getMemoryUsage() - retiringMemory <= budget) return;
+
+    // Hysteresis: never evict just outside renderDistance, so chunks on the
+    // border don't thrash when the camera moves back and forth
+    int keepDistance = std::max(evictionDistance, renderDistance + 1);
+
+    std::vector<ChunkSlot>& slots = grid.getSlots();
+    std::vector<std::pair<unsigned long long, size_t>> candidates;
+    size_t residentBytes = 0;
+    for (size_t i = 0; i < slots.size(); i++) {
+        const ChunkSlot& slot = slots[i];
+        if (slot.state != ChunkSlotState_Resident) continue;
+        residentBytes += slot.chunk->getGpuBytes() + slot.chunk->getCpuBytes();
+
+        int distance = std::max(std::abs(slot.chunkX - camChunkX), std::abs(slot.chunkZ - camChunkZ));
+        if (distance > keepDistance) {
+            candidates.emplace_back(slot.lastDrawnFrame, i);
+        }
+    }
+
+    // The budget is checked against the same bytes each retired chunk gives back; if the
+    // running counters drift from the chunks, eviction would stop too early or never
+    size_t sharedBytes = 0;
+    for (const auto& entry : arenas) {
+        sharedBytes += entry.second->getIndexBuffer().getBytes();
+    }
+    if (residentBytes + sharedBytes != getMemoryUsage() - retiringMemory) {
+        std::cout << "WARNING: Chunk memory counters disagree with resident chunks ("
+                  << getMemoryUsage() - retiringMemory << " vs " << residentBytes + sharedBytes
+                  << " bytes)" << std::endl;
+    }
+
+    // Least recently drawn first
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& candidate : candidates) {
+        if (getMemoryUsage() - retiringMemory <= budget) break;
+        retireChunk(slots[candidate.second]);
+    }
+}
+
+void TerrainManager::update(const Camera& camera, float deltaTime) {
+    frameIndex++;
+    collectCompletedChunks();
+
+    // First frame, or renderDistance/evictionDistance changed: start over on a new grid
+    int dimension = getRequiredGridDimension();
+    if (grid.getDimension() != dimension) {
+        for (ChunkSlot& slot : grid.getSlots()) {
+            if (slot.state == ChunkSlotState_Resident) {
+                retireChunk(slot);
+            }
+        }
+        grid.reset(dimension);
+        uploadQueue.clear();
+        chunkRequests.clear();
+    }
+
+    processMainThreadWork();
+
+    glm::vec3 cameraPos = camera.getCameraPos();
+    updateCameraVelocity(cameraPos, deltaTime);
+
+    Frustum frustum(camera.getViewProjectionMatrix());
     int camChunkX = floor(cameraPos.x / chunkSize);
     int camChunkZ = floor(cameraPos.z / chunkSize);
 
+    drawnChunks = 0;
+    culledChunks = 0;
+    drawnTriangles = 0;
+    drawCalls = 0;
+    programBinds = 0;
+
     for (int dz = -renderDistance; dz <= renderDistance; dz++) {
         for (int dx = -renderDistance; dx <= renderDistance; dx++) {
             int cx = camChunkX + dx;
             int cz = camChunkZ + dz;
-            long long key = hash(cx, cz);
+            ChunkSlot& slot = grid.at(cx, cz);
 
-            if (chunks.find(key) == chunks.end()) {
-                chunks[key] = new TerrainChunk(cx, cz, chunkSize, noiseFreq, noiseAmp);
+            if (!slot.holds(cx, cz)) {
+                // Not requested yet: queue it and skip it this frame
+                queueChunk(cx, cz, false);
+                continue;
             }
 
-            chunks[key]->draw(camera);  // Pass matrices
+            // First time a prefetched chunk is needed: did it arrive in time?
+            if (slot.prefetched) {
+                slot.prefetched = false;
+                if (slot.state == ChunkSlotState_Resident) prefetchHits++;
+                else prefetchLate++;
+            }
+
+            if (slot.state != ChunkSlotState_Resident) continue;
+
+            if (!frustum.intersectsAABB(slot.boundsMin, slot.boundsMax)) {
+                culledChunks++;
+                continue;
+            }
+
+            // Mask 0 can't come out of generation; treat it as every band to be safe
+            unsigned int layerMask = slot.layerMask;
+            if (layerMask == 0 || layerMask >= MATERIAL_PERMUTATIONS) {
+                layerMask = MATERIAL_PERMUTATIONS - 1;
+            }
+            drawLists[layerMask].emplace_back(&slot, selectLod(slot, cameraPos));
+        }
+    }
+
+    if (prefetchSeconds > 0.0f) {
+        prefetchChunks(camChunkX, camChunkZ);
+    }
+    else {
+        prefetchReach = 0;
+    }
+    scheduleChunkRequests(camera, frustum, camChunkX, camChunkZ);
+
+    // One program switch per permutation in view, and one multi-draw per arena under it
+    beginTerrainPass();
+
+    for (int mask = 1; mask < MATERIAL_PERMUTATIONS; mask++) {
+        std::vector<std::pair<ChunkSlot*, int>>& drawList = drawLists[mask];
+        if (drawList.empty()) continue;
+
+        bindTerrainProgram(mask, camera);
+        programBinds++;
+
+        TerrainProgram& program = terrainPrograms[mask];
+        for (auto& arenaEntry : arenas) {
+            TerrainVertexArena& arena = *arenaEntry.second;
+
+            drawBatch.clear();
+            for (const auto& entry : drawList) {
+                TerrainChunk* chunk = entry.first->chunk;
+                if (&chunk->getArena() != &arena) continue;
+
+                drawnTriangles += chunk->addToBatch(drawBatch, entry.second);
+                entry.first->lastDrawnFrame = frameIndex;
+                drawnChunks++;
+            }
+
+            if (!drawBatch.empty()) {
+                arena.draw(*program.shader, program.uniforms.arena, drawBatch);
+                drawCalls++;
+            }
         }
+        drawList.clear();
     }
+
+    endTerrainPass();
+
+    evictChunks(camChunkX, camChunkZ);
 }
@@ -0,0 +1,410 @@
+#include "TerrainNoise.h"
+#include "FastNoiseLite.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TERRAIN_NOISE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC accepts any intrinsic without /arch; GCC and Clang need per-function targets
+#if defined(TERRAIN_NOISE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TERRAIN_NOISE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define TERRAIN_NOISE_TARGET(isa)
+#endif
+
+namespace {
+
+const int PRIME_X = 501125321;
+const int PRIME_Y = 1136930381;
+const int HASH_MULTIPLIER = 0x27d4eb2d;
+const float PERLIN_SCALE = 1.4247691104677813f;
+
+// Same table as FastNoiseLite's Lookup<float>::Gradients2D
+const float GRADIENTS_2D[256] = {
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+    0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+    0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+    -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+    -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+    -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+    -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+};
+
+// Integer wrap-around as FastNoiseLite relies on, without signed overflow
+inline int wrapMul(int a, int b) {
+    return static_cast<int>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+}
+
+inline int wrapAdd(int a, int b) {
+    return static_cast<int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+inline int fastFloor(float f) {
+    return f >= 0 ? static_cast<int>(f) : static_cast<int>(f) - 1;
+}
+
+inline float interpQuintic(float t) {
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+inline float lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+inline float gradCoord(int seed, int xPrimed, int yPrimed, float xd, float yd) {
+    int hash = wrapMul(seed ^ xPrimed ^ yPrimed, HASH_MULTIPLIER);
+    hash ^= hash >> 15;
+    hash &= 127 << 1;
+    return xd * GRADIENTS_2D[hash] + yd * GRADIENTS_2D[hash | 1];
+}
+
+// Everything that only depends on the row's y coordinate
+struct RowState {
+    int y0Primed;
+    int y1Primed;
+    float yd0;
+    float yd1;
+    float ys;
+};
+
+RowState makeRowState(float y) {
+    RowState row;
+    int y0 = fastFloor(y);
+    row.yd0 = y - y0;
+    row.yd1 = row.yd0 - 1;
+    row.ys = interpQuintic(row.yd0);
+    row.y0Primed = wrapMul(y0, PRIME_Y);
+    row.y1Primed = wrapAdd(row.y0Primed, PRIME_Y);
+    return row;
+}
+
+inline float perlinSample(int seed, float x, const RowState& row) {
+    int x0 = fastFloor(x);
+    float xd0 = x - x0;
+    float xd1 = xd0 - 1;
+    float xs = interpQuintic(xd0);
+
+    int x0Primed = wrapMul(x0, PRIME_X);
+    int x1Primed = wrapAdd(x0Primed, PRIME_X);
+
+    float xf0 = lerp(gradCoord(seed, x0Primed, row.y0Primed, xd0, row.yd0),
+        gradCoord(seed, x1Primed, row.y0Primed, xd1, row.yd0), xs);
+    float xf1 = lerp(gradCoord(seed, x0Primed, row.y1Primed, xd0, row.yd1),
+        gradCoord(seed, x1Primed, row.y1Primed, xd1, row.yd1), xs);
+
+    return lerp(xf0, xf1, row.ys) * PERLIN_SCALE;
+}
+
+void perlinRowScalar(int seed, float frequency, const RowState& row, int startX, int count, float coordScale, float* out) {
+    for (int i = 0; i < count; i++) {
+        float x = static_cast<float>(startX + i) * coordScale * frequency;
+        out[i] = perlinSample(seed, x, row);
+    }
+}
+
+#if defined(TERRAIN_NOISE_X86)
+
+TERRAIN_NOISE_TARGET("sse4.1")
+inline __m128 gradCoordSSE41(__m128i seed, __m128i xPrimed, __m128i yPrimed, __m128 xd, __m128 yd) {
+    __m128i hash = _mm_xor_si128(seed, _mm_xor_si128(xPrimed, yPrimed));
+    hash = _mm_mullo_epi32(hash, _mm_set1_epi32(HASH_MULTIPLIER));
+    hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+    hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+    // No gather before AVX2
+    alignas(16) int lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), hash);
+    __m128 xg = _mm_setr_ps(GRADIENTS_2D[lanes[0]], GRADIENTS_2D[lanes[1]], GRADIENTS_2D[lanes[2]], GRADIENTS_2D[lanes[3]]);
+    __m128 yg = _mm_setr_ps(GRADIENTS_2D[lanes[0] | 1], GRADIENTS_2D[lanes[1] | 1], GRADIENTS_2D[lanes[2] | 1], GRADIENTS_2D[lanes[3] | 1]);
+
+    return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+}
+
+TERRAIN_NOISE_TARGET("sse4.1")
+inline __m128 interpQuinticSSE41(__m128 t) {
+    __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+TERRAIN_NOISE_TARGET("sse4.1")
+inline __m128 lerpSSE41(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+TERRAIN_NOISE_TARGET("sse4.1")
+void perlinRowSSE41(int seed, float frequency, const RowState& row, int startX, int count, float coordScale, float* out) {
+    const __m128i seedV = _mm_set1_epi32(seed);
+    const __m128 scale = _mm_set1_ps(coordScale);
+    const __m128 freq = _mm_set1_ps(frequency);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+
+    const __m128i y0Primed = _mm_set1_epi32(row.y0Primed);
+    const __m128i y1Primed = _mm_set1_epi32(row.y1Primed);
+    const __m128 yd0 = _mm_set1_ps(row.yd0);
+    const __m128 yd1 = _mm_set1_ps(row.yd1);
+    const __m128 ys = _mm_set1_ps(row.ys);
+
+    for (int i = 0; i < count; i += 4) {
+        __m128i worldX = _mm_add_epi32(_mm_set1_epi32(startX + i), laneOffsets);
+        __m128 x = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(worldX), scale), freq);
+
+        // Truncate, then step down for negatives (FastFloor semantics)
+        __m128i x0 = _mm_cvttps_epi32(x);
+        x0 = _mm_add_epi32(x0, _mm_castps_si128(_mm_cmplt_ps(x, _mm_setzero_ps())));
+
+        __m128 xd0 = _mm_sub_ps(x, _mm_cvtepi32_ps(x0));
+        __m128 xd1 = _mm_sub_ps(xd0, one);
+        __m128 xs = interpQuinticSSE41(xd0);
+
+        __m128i x0Primed = _mm_mullo_epi32(x0, _mm_set1_epi32(PRIME_X));
+        __m128i x1Primed = _mm_add_epi32(x0Primed, _mm_set1_epi32(PRIME_X));
+
+        __m128 xf0 = lerpSSE41(gradCoordSSE41(seedV, x0Primed, y0Primed, xd0, yd0),
+            gradCoordSSE41(seedV, x1Primed, y0Primed, xd1, yd0), xs);
+        __m128 xf1 = lerpSSE41(gradCoordSSE41(seedV, x0Primed, y1Primed, xd0, yd1),
+            gradCoordSSE41(seedV, x1Primed, y1Primed, xd1, yd1), xs);
+
+        __m128 result = _mm_mul_ps(lerpSSE41(xf0, xf1, ys), _mm_set1_ps(PERLIN_SCALE));
+
+        if (i + 4 <= count) {
+            _mm_storeu_ps(out + i, result);
+        }
+        else {
+            // Partial last batch: evaluate the full vector, keep what fits
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, result);
+            std::copy(lanes, lanes + (count - i), out + i);
+        }
+    }
+}
+
+TERRAIN_NOISE_TARGET("avx2")
+inline __m256 gradCoordAVX2(__m256i seed, __m256i xPrimed, __m256i yPrimed, __m256 xd, __m256 yd) {
+    __m256i hash = _mm256_xor_si256(seed, _mm256_xor_si256(xPrimed, yPrimed));
+    hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(HASH_MULTIPLIER));
+    hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+    hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+
+    __m256 xg = _mm256_i32gather_ps(GRADIENTS_2D, hash, 4);
+    __m256 yg = _mm256_i32gather_ps(GRADIENTS_2D, _mm256_or_si256(hash, _mm256_set1_epi32(1)), 4);
+
+    return _mm256_add_ps(_mm256_mul_ps(xd, xg), _mm256_mul_ps(yd, yg));
+}
+
+TERRAIN_NOISE_TARGET("avx2")
+inline __m256 interpQuinticAVX2(__m256 t) {
+    __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+}
+
+TERRAIN_NOISE_TARGET("avx2")
+inline __m256 lerpAVX2(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+TERRAIN_NOISE_TARGET("avx2")
+void perlinRowAVX2(int seed, float frequency, const RowState& row, int startX, int count, float coordScale, float* out) {
+    const __m256i seedV = _mm256_set1_epi32(seed);
+    const __m256 scale = _mm256_set1_ps(coordScale);
+    const __m256 freq = _mm256_set1_ps(frequency);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    const __m256i y0Primed = _mm256_set1_epi32(row.y0Primed);
+    const __m256i y1Primed = _mm256_set1_epi32(row.y1Primed);
+    const __m256 yd0 = _mm256_set1_ps(row.yd0);
+    const __m256 yd1 = _mm256_set1_ps(row.yd1);
+    const __m256 ys = _mm256_set1_ps(row.ys);
+
+    for (int i = 0; i < count; i += 8) {
+        __m256i worldX = _mm256_add_epi32(_mm256_set1_epi32(startX + i), laneOffsets);
+        __m256 x = _mm256_mul_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(worldX), scale), freq);
+
+        // Truncate, then step down for negatives (FastFloor semantics)
+        __m256i x0 = _mm256_cvttps_epi32(x);
+        x0 = _mm256_add_epi32(x0, _mm256_castps_si256(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ)));
+
+        __m256 xd0 = _mm256_sub_ps(x, _mm256_cvtepi32_ps(x0));
+        __m256 xd1 = _mm256_sub_ps(xd0, one);
+        __m256 xs = interpQuinticAVX2(xd0);
+
+        __m256i x0Primed = _mm256_mullo_epi32(x0, _mm256_set1_epi32(PRIME_X));
+        __m256i x1Primed = _mm256_add_epi32(x0Primed, _mm256_set1_epi32(PRIME_X));
+
+        __m256 xf0 = lerpAVX2(gradCoordAVX2(seedV, x0Primed, y0Primed, xd0, yd0),
+            gradCoordAVX2(seedV, x1Primed, y0Primed, xd1, yd0), xs);
+        __m256 xf1 = lerpAVX2(gradCoordAVX2(seedV, x0Primed, y1Primed, xd0, yd1),
+            gradCoordAVX2(seedV, x1Primed, y1Primed, xd1, yd1), xs);
+
+        __m256 result = _mm256_mul_ps(lerpAVX2(xf0, xf1, ys), _mm256_set1_ps(PERLIN_SCALE));
+
+        if (i + 8 <= count) {
+            _mm256_storeu_ps(out + i, result);
+        }
+        else {
+            // Partial last batch: evaluate the full vector, keep what fits. Staying in
+            // AVX code here also avoids an AVX/SSE transition into the scalar loop.
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, result);
+            std::copy(lanes, lanes + (count - i), out + i);
+        }
+    }
+}
+
+bool cpuHasSSE41() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+bool cpuHasAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    if (!osSavesYmm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // TERRAIN_NOISE_X86
+
+} // namespace
+
+TerrainNoise::TerrainNoise(int seed, float frequency)
+    : seed(seed), frequency(frequency), backend(getBestBackend())
+{
+}
+
+TerrainNoise::Backend TerrainNoise::getBestBackend() {
+#if defined(TERRAIN_NOISE_X86)
+    static const Backend best = cpuHasAVX2() ? Backend_AVX2 : (cpuHasSSE41() ? Backend_SSE41 : Backend_Scalar);
+    return best;
+#else
+    return Backend_Scalar;
+#endif
+}
+
+void TerrainNoise::setBackend(Backend requested) {
+    backend = std::min(requested, getBestBackend());
+}
+
+const char* TerrainNoise::getBackendName(Backend backend) {
+    switch (backend) {
+    case Backend_AVX2: return "AVX2";
+    case Backend_SSE41: return "SSE4.1";
+    case Backend_Scalar: return "Scalar";
+    default: return "FastNoiseLite";
+    }
+}
+
+void TerrainNoise::evaluateRow(float y, int startX, int count, float coordScale, float* out) const {
+    RowState row = makeRowState(y);
+
+    switch (backend) {
+#if defined(TERRAIN_NOISE_X86)
+    case Backend_AVX2:
+        perlinRowAVX2(seed, frequency, row, startX, count, coordScale, out);
+        break;
+    case Backend_SSE41:
+        perlinRowSSE41(seed, frequency, row, startX, count, coordScale, out);
+        break;
+#endif
+    default:
+        perlinRowScalar(seed, frequency, row, startX, count, coordScale, out);
+        break;
+    }
+}
+
+void TerrainNoise::evaluateGrid(int startX, int startZ, int width, int height, float coordScale, float* out) const {
+    if (backend == Backend_Reference) {
+        FastNoiseLite reference(seed);
+        reference.SetFrequency(frequency);
+        reference.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+        reference.SetFractalType(FastNoiseLite::FractalType_None);
+
+        for (int z = 0; z < height; z++) {
+            for (int x = 0; x < width; x++) {
+                float worldX = static_cast<float>(startX + x);
+                float worldZ = static_cast<float>(startZ + z);
+                out[z * width + x] = reference.GetNoise(worldX * coordScale, worldZ * coordScale);
+            }
+        }
+        return;
+    }
+
+    for (int z = 0; z < height; z++) {
+        float y = static_cast<float>(startZ + z) * coordScale * frequency;
+        evaluateRow(y, startX, width, coordScale, out + z * width);
+    }
+}
+
+float TerrainNoise::measureMaxError(float coordScale, int sampleCount) const {
+    FastNoiseLite reference(seed);
+    reference.SetFrequency(frequency);
+    reference.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    reference.SetFractalType(FastNoiseLite::FractalType_None);
+
+    const int width = 64;
+    const int height = std::max(1, sampleCount / width);
+
+    std::vector<float> samples(width * height);
+    float maxError = 0.0f;
+
+    // One patch straddling the origin and one far out, to cover negative floors and large hashes
+    const int origins[2][2] = { { -width / 2, -height / 2 }, { 123457, -98765 } };
+    for (const auto& origin : origins) {
+        evaluateGrid(origin[0], origin[1], width, height, coordScale, samples.data());
+
+        for (int z = 0; z < height; z++) {
+            for (int x = 0; x < width; x++) {
+                float worldX = static_cast<float>(origin[0] + x);
+                float worldZ = static_cast<float>(origin[1] + z);
+                float expected = reference.GetNoise(worldX * coordScale, worldZ * coordScale);
+                maxError = std::max(maxError, std::fabs(expected - samples[z * width + x]));
+            }
+        }
+    }
+    return maxError;
+}
@@ -0,0 +1,53 @@
+#include "TerrainNormals.h"
+#include <cmath>
+
+// SSE2 is part of every x64 target and MSVC's default for x86, so no runtime dispatch
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_NORMALS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+    const float SNORM16_SCALE = 32767.0f;
+}
+
+void encodeNormalRowScalar(const float* above, const float* row, const float* below, int count, int16_t* out) {
+    for (int x = 0; x < count; x++) {
+        // Unnormalized normal (-dh/dx, 1, -dh/dz); the octahedral projection divides by
+        // its L1 norm, so it never needs a square root
+        float nx = (row[x - 1] - row[x + 1]) * 0.5f;
+        float nz = (above[x] - below[x]) * 0.5f;
+        float invL1 = SNORM16_SCALE / (std::fabs(nx) + std::fabs(nz) + 1.0f);
+
+        out[2 * x] = static_cast<int16_t>(std::lrint(nx * invL1));
+        out[2 * x + 1] = static_cast<int16_t>(std::lrint(nz * invL1));
+    }
+}
+
+void encodeNormalRow(const float* above, const float* row, const float* below, int count, int16_t* out) {
+#if defined(TERRAIN_NORMALS_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(SNORM16_SCALE);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128 nx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x - 1), _mm_loadu_ps(row + x + 1)), half);
+        __m128 nz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(above + x), _mm_loadu_ps(below + x)), half);
+        __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_and_ps(nx, absMask), _mm_and_ps(nz, absMask)), one);
+        __m128 invL1 = _mm_div_ps(scale, l1);
+
+        // Round to nearest like lrint, then interleave (x, z) pairs and saturate to 16 bits
+        __m128i ix = _mm_cvtps_epi32(_mm_mul_ps(nx, invL1));
+        __m128i iz = _mm_cvtps_epi32(_mm_mul_ps(nz, invL1));
+        __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(ix, iz), _mm_unpackhi_epi32(ix, iz));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * x), packed);
+    }
+
+    encodeNormalRowScalar(above + x, row + x, below + x, count - x, out + 2 * x);
+#else
+    encodeNormalRowScalar(above, row, below, count, out);
+#endif
+}
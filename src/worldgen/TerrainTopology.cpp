@@ -0,0 +1,81 @@
+#include "TerrainTopology.h"
+#include "VertexCache.h"
+
+std::vector<uint32_t> buildTerrainIndices(int size, int maxLevels, bool optimizeForCache,
+    std::vector<TerrainLodIndices>& lods) {
+    std::vector<uint32_t> indices;
+    lods.clear();
+
+    const int rowLength = size + 1;
+    const int skirtStart = getTerrainGridVertexCount(size);
+
+    auto gridIndex = [rowLength](int x, int z) { return static_cast<uint32_t>(z * rowLength + x); };
+
+    // Skirt ring order: north (z = 0), south (z = size), west (x = 0), east (x = size)
+    auto skirtIndex = [skirtStart, rowLength](int side, int i) {
+        return static_cast<uint32_t>(skirtStart + side * rowLength + i);
+    };
+
+    for (int level = 0; level < maxLevels; level++) {
+        int stride = 1 << level;
+        if (stride > size || size % stride != 0) break;
+
+        TerrainLodIndices lod;
+        lod.stride = stride;
+        lod.firstIndex = indices.size();
+
+        for (int z = 0; z < size; z += stride) {
+            for (int x = 0; x < size; x += stride) {
+                uint32_t topLeft = gridIndex(x, z);
+                uint32_t topRight = gridIndex(x + stride, z);
+                uint32_t bottomLeft = gridIndex(x, z + stride);
+                uint32_t bottomRight = gridIndex(x + stride, z + stride);
+
+                indices.push_back(topLeft);
+                indices.push_back(bottomLeft);
+                indices.push_back(topRight);
+
+                indices.push_back(topRight);
+                indices.push_back(bottomLeft);
+                indices.push_back(bottomRight);
+            }
+        }
+
+        // Skirt quads, wound to face away from the chunk
+        for (int i = 0; i < size; i += stride) {
+            int j = i + stride;
+
+            uint32_t edges[4][2] = {
+                { gridIndex(i, 0), gridIndex(j, 0) },
+                { gridIndex(i, size), gridIndex(j, size) },
+                { gridIndex(0, i), gridIndex(0, j) },
+                { gridIndex(size, i), gridIndex(size, j) }
+            };
+
+            for (int side = 0; side < 4; side++) {
+                uint32_t edgeA = edges[side][0];
+                uint32_t edgeB = edges[side][1];
+                uint32_t skirtA = skirtIndex(side, i);
+                uint32_t skirtB = skirtIndex(side, j);
+
+                bool flip = (side == 1 || side == 2);
+
+                indices.push_back(edgeA);
+                indices.push_back(flip ? skirtA : edgeB);
+                indices.push_back(flip ? edgeB : skirtA);
+
+                indices.push_back(edgeB);
+                indices.push_back(flip ? skirtA : skirtB);
+                indices.push_back(flip ? skirtB : skirtA);
+            }
+        }
+
+        lod.indexCount = indices.size() - lod.firstIndex;
+        if (optimizeForCache) {
+            optimizeVertexCache(&indices[lod.firstIndex], lod.indexCount, getTerrainVertexCount(size));
+        }
+        lods.push_back(lod);
+    }
+
+    return indices;
+}
@@ -0,0 +1,187 @@
+#include "TerrainVertexArena.h"
+#include <algorithm>
+#include <cstddef>
+
+TerrainVertexArena::TerrainVertexArena(int size, int initialSlots)
+    : indexBuffer(new TerrainIndexBuffer(size)),
+    slotVertices(TerrainIndexBuffer::getVertexCount(size)),
+    minCapacity(std::max(initialSlots, 1))
+{
+    glGenVertexArrays(1, &VAO);
+    glGenTextures(1, &slotTexture);
+    resize(minCapacity);
+}
+
+TerrainVertexArena::~TerrainVertexArena() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &slotBuffer);
+    glDeleteTextures(1, &slotTexture);
+}
+
+void TerrainVertexArena::resize(int newCapacity) {
+    // Where each live slot ends up: in place if it fits, else the lowest free slot that does
+    std::vector<std::pair<int, int>> moves;
+    size_t nextFree = 0;
+    std::vector<int> lowFree;
+    for (int slot = 0; slot < std::min(capacity, newCapacity); slot++) {
+        if (!slotOwners[slot]) lowFree.push_back(slot);
+    }
+    for (int slot = 0; slot < capacity; slot++) {
+        if (!slotOwners[slot]) continue;
+        moves.emplace_back(slot, slot < newCapacity ? slot : lowFree[nextFree++]);
+    }
+
+    // Fresh buffers at the new size, with the live slots copied across on the GPU
+    GLuint newVBO, newSlotBuffer;
+    glGenBuffers(1, &newVBO);
+    glGenBuffers(1, &newSlotBuffer);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newVBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * getSlotBytes(), nullptr, GL_STATIC_DRAW);
+    if (VBO) {
+        glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+        if (newCapacity >= capacity) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacity * getSlotBytes());
+        }
+        else {
+            for (const auto& move : moves) {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                    move.first * getSlotBytes(), move.second * getSlotBytes(), getSlotBytes());
+            }
+        }
+        glDeleteBuffers(1, &VBO);
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newSlotBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+    if (slotBuffer) {
+        glBindBuffer(GL_COPY_READ_BUFFER, slotBuffer);
+        if (newCapacity >= capacity) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacity * sizeof(glm::vec4));
+        }
+        else {
+            for (const auto& move : moves) {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                    move.first * sizeof(glm::vec4), move.second * sizeof(glm::vec4), sizeof(glm::vec4));
+            }
+        }
+        glDeleteBuffers(1, &slotBuffer);
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    VBO = newVBO;
+    slotBuffer = newSlotBuffer;
+
+    glBindTexture(GL_TEXTURE_BUFFER, slotTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, slotBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    // Point the owners of moved slots at their new index
+    std::vector<int*> owners(newCapacity, nullptr);
+    for (const auto& move : moves) {
+        owners[move.second] = slotOwners[move.first];
+        *owners[move.second] = move.second;
+    }
+    slotOwners.swap(owners);
+
+    // Pushed in reverse so the lowest slots are handed out first
+    freeSlots.clear();
+    for (int slot = newCapacity - 1; slot >= 0; slot--) {
+        if (!slotOwners[slot]) freeSlots.push_back(slot);
+    }
+    capacity = newCapacity;
+
+    // Attribute pointers capture the buffer, so they follow it to the new one
+    setupVertexArray();
+}
+
+void TerrainVertexArena::setupVertexArray() {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    // Topology is shared with every chunk of this size
+    indexBuffer->bind();
+
+    // Vertex attribute - quantized height, unpacked to [0, 1]
+    glVertexAttribPointer(0, 1, GL_UNSIGNED_SHORT, GL_TRUE,
+        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, height));
+    glEnableVertexAttribArray(0);
+
+    // Vertex attribute - material weights, unpacked to [0, 1]
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, weights));
+    glEnableVertexAttribArray(1);
+
+    // Vertex attribute - octahedral normal, unpacked to [-1, 1]
+    glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE,
+        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, normal));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+}
+
+void TerrainVertexArena::allocate(int& slotRef, const std::vector<TerrainVertex>& vertices, const glm::vec3& offset,
+    float heightBase, float heightRange) {
+    if (freeSlots.empty()) {
+        resize(capacity * 2);
+    }
+
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    slotOwners[slot] = &slotRef;
+    slotRef = slot;
+    liveSlots++;
+
+    size_t count = std::min(vertices.size(), static_cast<size_t>(slotVertices));
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, slot * getSlotBytes(), count * sizeof(TerrainVertex), vertices.data());
+
+    glm::vec4 slotData(offset.x, offset.z, heightBase, heightRange);
+    glBindBuffer(GL_TEXTURE_BUFFER, slotBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, slot * sizeof(glm::vec4), sizeof(glm::vec4), &slotData);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void TerrainVertexArena::release(int slot) {
+    slotOwners[slot] = nullptr;
+    freeSlots.push_back(slot);
+    liveSlots--;
+}
+
+bool TerrainVertexArena::shrinkToFit() {
+    int newCapacity = capacity;
+    while (newCapacity / 2 >= minCapacity && liveSlots * 4 <= newCapacity) {
+        newCapacity /= 2;
+    }
+    if (newCapacity == capacity) return false;
+
+    resize(newCapacity);
+    return true;
+}
+
+int TerrainVertexArena::addDraw(TerrainDrawBatch& batch, int slot, int lodLevel) const {
+    const TerrainIndexBuffer::LodRange& lod = indexBuffer->getLod(lodLevel);
+
+    batch.counts.push_back(lod.indexCount);
+    batch.offsets.push_back(reinterpret_cast<const void*>(lod.byteOffset));
+    batch.baseVertices.push_back(slot * slotVertices);
+
+    return lod.indexCount / 3;
+}
+
+void TerrainVertexArena::draw(Shader& shader, const TerrainArenaUniforms& uniforms, const TerrainDrawBatch& batch) const {
+    if (batch.empty()) return;
+
+    shader.setInt(uniforms.gridSize, getSize());
+    shader.setInt(uniforms.slotVertices, slotVertices);
+
+    glActiveTexture(GL_TEXTURE0 + SLOT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, slotTexture);
+
+    glBindVertexArray(VAO);
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, batch.counts.data(), indexBuffer->getIndexType(),
+        batch.offsets.data(), static_cast<GLsizei>(batch.counts.size()), batch.baseVertices.data());
+}
@@ -0,0 +1,168 @@
+#include "VertexCache.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+    const int CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    float scoreVertex(int cachePosition, int remainingTriangles) {
+        // No triangles left to use it, so it never drives a choice
+        if (remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            // The last triangle's three vertices score the same, so the next triangle
+            // doesn't depend on the order they were emitted in
+            if (cachePosition < 3) {
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else {
+                float scale = 1.0f / (CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+            }
+        }
+
+        // Finish off vertices with few triangles left before they drop out of the cache
+        score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+        return score;
+    }
+}
+
+VertexCacheStats measureVertexCache(const uint32_t* indices, size_t indexCount, int vertexCount, int cacheSize) {
+    VertexCacheStats stats;
+    if (indexCount < 3) return stats;
+
+    // Timestamp of each vertex's last miss; it is still cached while fewer than
+    // cacheSize misses have happened since
+    std::vector<long long> insertedAt(vertexCount, -1);
+    std::vector<bool> referenced(vertexCount, false);
+    long long misses = 0;
+    int uniqueVertices = 0;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t vertex = indices[i];
+        if (!referenced[vertex]) {
+            referenced[vertex] = true;
+            uniqueVertices++;
+        }
+        if (insertedAt[vertex] < 0 || misses - insertedAt[vertex] >= cacheSize) {
+            insertedAt[vertex] = misses;
+            misses++;
+        }
+    }
+
+    stats.acmr = static_cast<double>(misses) / (indexCount / 3);
+    stats.atvr = static_cast<double>(misses) / uniqueVertices;
+    return stats;
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, int vertexCount) {
+    const int triangleCount = static_cast<int>(indexCount / 3);
+    if (triangleCount == 0) return;
+
+    // Triangles around each vertex, as offsets into one flat adjacency array
+    std::vector<int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; i++) {
+        remaining[indices[i]]++;
+    }
+
+    std::vector<int> adjacencyStart(vertexCount + 1, 0);
+    for (int v = 0; v < vertexCount; v++) {
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+    }
+    std::vector<int> adjacency(adjacencyStart[vertexCount]);
+    std::vector<int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (int t = 0; t < triangleCount; t++) {
+        for (int corner = 0; corner < 3; corner++) {
+            adjacency[fill[indices[t * 3 + corner]]++] = t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (int v = 0; v < vertexCount; v++) {
+        vertexScore[v] = scoreVertex(-1, remaining[v]);
+    }
+
+    auto scoreTriangle = [&](int t) {
+        return vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    };
+
+    std::vector<bool> emitted(triangleCount, false);
+    int bestTriangle = 0;
+    for (int t = 1; t < triangleCount; t++) {
+        if (scoreTriangle(t) > scoreTriangle(bestTriangle)) bestTriangle = t;
+    }
+
+    std::vector<uint32_t> output;
+    output.reserve(indexCount);
+
+    // LRU cache, most recent first; CACHE_SIZE + 3 while a triangle is being inserted
+    std::vector<int> cache;
+    cache.reserve(CACHE_SIZE + 3);
+
+    int scanFrom = 0;
+
+    for (int emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (bestTriangle < 0) {
+            // Nothing in the cache touches a pending triangle; take the next unemitted one
+            while (emitted[scanFrom]) scanFrom++;
+            bestTriangle = scanFrom;
+        }
+
+        emitted[bestTriangle] = true;
+        const uint32_t* triangle = &indices[bestTriangle * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+
+        // Move the triangle's vertices to the front of the cache
+        std::vector<int> newCache(triangle, triangle + 3);
+        for (int vertex : cache) {
+            if (vertex != static_cast<int>(triangle[0]) && vertex != static_cast<int>(triangle[1])
+                && vertex != static_cast<int>(triangle[2])) {
+                newCache.push_back(vertex);
+            }
+        }
+
+        // The triangle no longer counts towards its vertices' valence
+        for (int corner = 0; corner < 3; corner++) {
+            int vertex = triangle[corner];
+            int* begin = &adjacency[adjacencyStart[vertex]];
+            int* end = begin + remaining[vertex];
+            *std::find(begin, end, bestTriangle) = *(end - 1);
+            remaining[vertex]--;
+        }
+
+        // Rescore everything that was or is in the cache, then the triangles around it
+        for (size_t i = 0; i < newCache.size(); i++) {
+            int vertex = newCache[i];
+            cachePosition[vertex] = i < static_cast<size_t>(CACHE_SIZE) ? static_cast<int>(i) : -1;
+            vertexScore[vertex] = scoreVertex(cachePosition[vertex], remaining[vertex]);
+        }
+
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (int vertex : newCache) {
+            for (int a = 0; a < remaining[vertex]; a++) {
+                int t = adjacency[adjacencyStart[vertex] + a];
+                float score = scoreTriangle(t);
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (newCache.size() > static_cast<size_t>(CACHE_SIZE)) {
+            newCache.resize(CACHE_SIZE);
+        }
+        cache.swap(newCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
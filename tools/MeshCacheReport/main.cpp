@@ -0,0 +1,85 @@
+// Reports post-transform vertex cache efficiency of the terrain index buffers, before
+// and after the Forsyth reordering TerrainIndexBuffer applies at startup.
+//
+// Usage: MeshCacheReport [size]...   (chunk sizes, default 16 32 64)
+//   ACMR: cache misses per triangle (lower is better, 0.5 is the limit for a grid)
+//   ATVR: cache misses per vertex   (lower is better, 1.0 is the limit)
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "TerrainTopology.h"
+#include "VertexCache.h"
+
+namespace {
+
+    const int MAX_LOD_LEVELS = 4;
+    const int CACHE_SIZES[] = { 16, 32 };
+
+    // Triangles rotated to start at their smallest index, then sorted, so two lists
+    // compare equal when they hold the same triangles with the same winding
+    std::vector<std::array<uint32_t, 3>> canonicalTriangles(const uint32_t* indices, size_t count) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i + 2 < count; i += 3) {
+            std::array<uint32_t, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+            while (t[0] > t[1] || t[0] > t[2]) {
+                std::rotate(t.begin(), t.begin() + 1, t.end());
+            }
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    bool reportSize(int size) {
+        std::vector<TerrainLodIndices> lods;
+        std::vector<TerrainLodIndices> optimizedLods;
+        std::vector<uint32_t> original = buildTerrainIndices(size, MAX_LOD_LEVELS, false, lods);
+        std::vector<uint32_t> optimized = buildTerrainIndices(size, MAX_LOD_LEVELS, true, optimizedLods);
+        int vertexCount = getTerrainVertexCount(size);
+
+        bool valid = true;
+        std::printf("Chunk size %d (%d vertices)\n", size, vertexCount);
+        for (size_t level = 0; level < lods.size(); level++) {
+            const TerrainLodIndices& lod = lods[level];
+            const uint32_t* before = &original[lod.firstIndex];
+            const uint32_t* after = &optimized[lod.firstIndex];
+
+            bool same = canonicalTriangles(before, lod.indexCount) == canonicalTriangles(after, lod.indexCount);
+            valid = valid && same;
+
+            std::printf("  LOD %zu (stride %d, %zu triangles)%s\n", level, lod.stride, lod.indexCount / 3,
+                same ? "" : "  ERROR: triangle set changed");
+            for (int cacheSize : CACHE_SIZES) {
+                VertexCacheStats a = measureVertexCache(before, lod.indexCount, vertexCount, cacheSize);
+                VertexCacheStats b = measureVertexCache(after, lod.indexCount, vertexCount, cacheSize);
+                std::printf("    FIFO %2d: ACMR %.3f -> %.3f   ATVR %.3f -> %.3f\n",
+                    cacheSize, a.acmr, b.acmr, a.atvr, b.atvr);
+            }
+        }
+        return valid;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        int size = std::atoi(argv[i]);
+        if (size <= 0) {
+            std::printf("Usage: MeshCacheReport [size]...\n");
+            return 1;
+        }
+        sizes.push_back(size);
+    }
+    if (sizes.empty()) {
+        sizes = { 16, 32, 64 };
+    }
+
+    bool valid = true;
+    for (int size : sizes) {
+        valid = reportSize(size) && valid;
+    }
+    return valid ? 0 : 1;
+}
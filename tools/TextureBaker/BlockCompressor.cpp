@@ -0,0 +1,229 @@
+#include "BlockCompressor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    // Fetches a 4x4 block, clamping reads past the right/bottom edge
+    void fetchBlock(const RawImage& image, int blockX, int blockY, int channel, int count, float block[16][3]) {
+        for (int y = 0; y < 4; y++) {
+            int sy = std::min(blockY * 4 + y, image.height - 1);
+            for (int x = 0; x < 4; x++) {
+                int sx = std::min(blockX * 4 + x, image.width - 1);
+                const uint8_t* pixel = &image.pixels[(static_cast<size_t>(sy) * image.width + sx) * image.channels];
+                for (int c = 0; c < count; c++) {
+                    // Grayscale sources feed every requested channel from channel 0
+                    int source = std::min(channel + c, image.channels - 1);
+                    block[y * 4 + x][c] = pixel[source];
+                }
+            }
+        }
+    }
+
+    uint16_t packRGB565(const float color[3]) {
+        int r = static_cast<int>(std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+        int g = static_cast<int>(std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+        int b = static_cast<int>(std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void unpackRGB565(uint16_t packed, float color[3]) {
+        int r = (packed >> 11) & 31;
+        int g = (packed >> 5) & 63;
+        int b = packed & 31;
+        color[0] = static_cast<float>((r << 3) | (r >> 2));
+        color[1] = static_cast<float>((g << 2) | (g >> 4));
+        color[2] = static_cast<float>((b << 3) | (b >> 2));
+    }
+
+    // Endpoints from the extremes of the block along its principal colour axis
+    void compressBlockBC1(const float block[16][3], uint8_t out[8]) {
+        float mean[3] = {};
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) mean[c] += block[i][c] / 16.0f;
+        }
+
+        float cov[6] = {};
+        for (int i = 0; i < 16; i++) {
+            float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+
+        // Power iteration for the dominant eigenvector
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iter = 0; iter < 8; iter++) {
+            float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            float length = std::sqrt(x * x + y * y + z * z);
+            if (length < 1e-6f) break;
+            axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+        }
+
+        float minT = 0.0f, maxT = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            float t = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        float high[3], low[3];
+        for (int c = 0; c < 3; c++) {
+            high[c] = mean[c] + axis[c] * maxT;
+            low[c] = mean[c] + axis[c] * minT;
+        }
+
+        uint16_t color0 = packRGB565(high);
+        uint16_t color1 = packRGB565(low);
+        // color0 > color1 selects the opaque four-colour mode
+        if (color0 < color1) std::swap(color0, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1) {
+            float palette[4][3];
+            unpackRGB565(color0, palette[0]);
+            unpackRGB565(color1, palette[1]);
+            for (int c = 0; c < 3; c++) {
+                palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+            }
+
+            for (int i = 0; i < 16; i++) {
+                int best = 0;
+                float bestError = 1e30f;
+                for (int p = 0; p < 4; p++) {
+                    float dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+                    float error = dr * dr + dg * dg + db * db;
+                    if (error < bestError) {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint32_t>(best) << (2 * i);
+            }
+        }
+
+        out[0] = color0 & 0xFF; out[1] = color0 >> 8;
+        out[2] = color1 & 0xFF; out[3] = color1 >> 8;
+        for (int b = 0; b < 4; b++) out[4 + b] = (indices >> (8 * b)) & 0xFF;
+    }
+
+    // Eight-value mode between the block's min and max
+    void compressBlockBC4(const float block[16][3], int channel, uint8_t out[8]) {
+        float lo = 255.0f, hi = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            lo = std::min(lo, block[i][channel]);
+            hi = std::max(hi, block[i][channel]);
+        }
+
+        uint8_t red0 = static_cast<uint8_t>(hi + 0.5f);
+        uint8_t red1 = static_cast<uint8_t>(lo + 0.5f);
+
+        uint64_t indices = 0;
+        if (red0 > red1) {
+            float palette[8];
+            palette[0] = red0;
+            palette[1] = red1;
+            for (int p = 1; p < 7; p++) {
+                palette[p + 1] = ((7 - p) * red0 + p * red1) / 7.0f;
+            }
+
+            for (int i = 0; i < 16; i++) {
+                int best = 0;
+                float bestError = 1e30f;
+                for (int p = 0; p < 8; p++) {
+                    float error = std::fabs(block[i][channel] - palette[p]);
+                    if (error < bestError) {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+
+        out[0] = red0;
+        out[1] = red1;
+        for (int b = 0; b < 6; b++) out[2 + b] = (indices >> (8 * b)) & 0xFF;
+    }
+}
+
+RawImage downsampleImage(const RawImage& image, bool isNormalMap) {
+    RawImage result;
+    result.width = std::max(image.width / 2, 1);
+    result.height = std::max(image.height / 2, 1);
+    result.channels = image.channels;
+    result.pixels.resize(static_cast<size_t>(result.width) * result.height * result.channels);
+
+    for (int y = 0; y < result.height; y++) {
+        int y0 = std::min(y * 2, image.height - 1);
+        int y1 = std::min(y * 2 + 1, image.height - 1);
+        for (int x = 0; x < result.width; x++) {
+            int x0 = std::min(x * 2, image.width - 1);
+            int x1 = std::min(x * 2 + 1, image.width - 1);
+
+            float sum[4] = {};
+            const int xs[2] = { x0, x1 };
+            const int ys[2] = { y0, y1 };
+            for (int sy : ys) {
+                for (int sx : xs) {
+                    const uint8_t* pixel = &image.pixels[(static_cast<size_t>(sy) * image.width + sx) * image.channels];
+                    for (int c = 0; c < image.channels; c++) sum[c] += pixel[c] / 4.0f;
+                }
+            }
+
+            // Averaged normals shorten; push them back onto the unit sphere
+            if (isNormalMap && image.channels >= 3) {
+                float n[3];
+                for (int c = 0; c < 3; c++) n[c] = sum[c] / 127.5f - 1.0f;
+                float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length > 1e-6f) {
+                    for (int c = 0; c < 3; c++) sum[c] = (n[c] / length + 1.0f) * 127.5f;
+                }
+            }
+
+            uint8_t* dest = &result.pixels[(static_cast<size_t>(y) * result.width + x) * result.channels];
+            for (int c = 0; c < image.channels; c++) {
+                dest[c] = static_cast<uint8_t>(std::min(std::max(sum[c] + 0.5f, 0.0f), 255.0f));
+            }
+        }
+    }
+
+    return result;
+}
+
+void compressImage(const RawImage& image, DDSFormat format, std::vector<uint8_t>& out) {
+    int blocksX = (image.width + 3) / 4;
+    int blocksY = (image.height + 3) / 4;
+    size_t start = out.size();
+    out.resize(start + getDDSLevelSize(format, image.width, image.height));
+    uint8_t* dest = out.data() + start;
+
+    float block[16][3];
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            switch (format) {
+            case DDSFormat_BC1:
+                fetchBlock(image, bx, by, 0, 3, block);
+                compressBlockBC1(block, dest);
+                dest += 8;
+                break;
+            case DDSFormat_BC4:
+                fetchBlock(image, bx, by, 0, 1, block);
+                compressBlockBC4(block, 0, dest);
+                dest += 8;
+                break;
+            case DDSFormat_BC5:
+                // Red block followed by green block
+                fetchBlock(image, bx, by, 0, 2, block);
+                compressBlockBC4(block, 0, dest);
+                compressBlockBC4(block, 1, dest + 8);
+                dest += 16;
+                break;
+            default:
+                return;
+            }
+        }
+    }
+}
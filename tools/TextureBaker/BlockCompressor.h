@@ -0,0 +1,24 @@
+#pragma once
+#ifndef BLOCKCOMPRESSOR_H
+#define BLOCKCOMPRESSOR_H
+
+#include <cstdint>
+#include <vector>
+#include "DDSFile.h"
+
+// 8-bit image in memory; pixels are tightly packed rows of `channels` bytes
+struct RawImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<uint8_t> pixels;
+};
+
+// Half-size box filter. Normal maps are renormalised after averaging.
+RawImage downsampleImage(const RawImage& image, bool isNormalMap);
+
+// Appends one compressed mip level to out. BC1 reads channels 0-2, BC4 channel 0 and
+// BC5 channels 0-1; edge blocks of odd-sized levels repeat the last row/column.
+void compressImage(const RawImage& image, DDSFormat format, std::vector<uint8_t>& out);
+
+#endif // BLOCKCOMPRESSOR_H
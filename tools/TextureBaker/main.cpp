@@ -0,0 +1,159 @@
+// Offline texture converter: bakes JPEG/PNG material maps into block-compressed DDS files
+// with a full mip chain, written next to the source image. TextureManager picks these up
+// at startup instead of decoding the source and generating mips on the GPU.
+//
+// Usage: TextureBaker [--force] [--orm <prefix>]... <image>...
+//   *_Color.*      -> BC1 (albedo)
+//   *_Normal*.*    -> BC5 (normal XY; the shader rebuilds Z)
+//   anything else  -> BC4
+//   --orm <prefix> -> <prefix>_ORM.dds, BC1 with AO/roughness/displacement in R/G/B,
+//                     read from <prefix>_AmbientOcclusion.jpg, _Roughness.jpg, _Displacement.jpg
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include "stb_image.h"
+#include "BlockCompressor.h"
+#include "DDSFile.h"
+#include "ORMPacker.h"
+
+namespace {
+
+    DDSFormat chooseFormat(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        if (name.find("_Color") != std::string::npos) return DDSFormat_BC1;
+        if (name.find("_Normal") != std::string::npos) return DDSFormat_BC5;
+        return DDSFormat_BC4;
+    }
+
+    // Compresses every level down to 1x1 and writes the DDS
+    bool writeMipChain(RawImage image, DDSFormat format, bool isNormalMap, const std::string& cachePath,
+        std::chrono::steady_clock::time_point start) {
+        DDSImage dds;
+        dds.format = format;
+        dds.width = image.width;
+        dds.height = image.height;
+
+        while (true) {
+            DDSMipLevel level = { image.width, image.height, dds.data.size(), 0 };
+            compressImage(image, format, dds.data);
+            level.size = dds.data.size() - level.offset;
+            dds.mips.push_back(level);
+
+            if (image.width == 1 && image.height == 1) break;
+            image = downsampleImage(image, isNormalMap);
+        }
+
+        if (!saveDDS(cachePath, dds)) {
+            std::cout << "Failed to write: " << cachePath << std::endl;
+            return false;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Baked " << cachePath << " (" << getDDSFormatName(format) << ", " << dds.width << "x" << dds.height
+                  << ", " << dds.mips.size() << " mips, " << dds.data.size() / 1024 << " KB) in " << ms << " ms" << std::endl;
+        return true;
+    }
+
+    bool bakeTexture(const std::string& sourcePath, bool force) {
+        std::string cachePath = getDDSCachePath(sourcePath);
+
+        struct stat info;
+        if (stat(sourcePath.c_str(), &info) != 0) {
+            std::cout << "Missing source image: " << sourcePath << std::endl;
+            return false;
+        }
+        if (!force && isDDSCacheCurrent(sourcePath, cachePath)) {
+            std::cout << "Up to date: " << cachePath << std::endl;
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        DDSFormat format = chooseFormat(sourcePath);
+        bool isNormalMap = format == DDSFormat_BC5;
+
+        // Rows are stored bottom-up, matching the flip the JPEG path applies on load
+        stbi_set_flip_vertically_on_load(true);
+        RawImage image;
+        unsigned char* pixels = stbi_load(sourcePath.c_str(), &image.width, &image.height, &image.channels,
+            format == DDSFormat_BC4 ? 1 : 3);
+        if (!pixels) {
+            std::cout << "Failed to decode: " << sourcePath << std::endl;
+            return false;
+        }
+        image.channels = format == DDSFormat_BC4 ? 1 : 3;
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(image.width) * image.height * image.channels);
+        stbi_image_free(pixels);
+
+        return writeMipChain(image, format, isNormalMap, cachePath, start);
+    }
+
+    bool bakeORM(const std::string& prefix, bool force) {
+        std::string cachePath = getORMCachePath(prefix);
+
+        bool current = true;
+        for (int channel = 0; channel < ORMChannel_Count; channel++) {
+            current = current && isDDSCacheCurrent(getORMSourcePath(prefix, static_cast<ORMChannel>(channel)), cachePath);
+        }
+        if (!force && current) {
+            std::cout << "Up to date: " << cachePath << std::endl;
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        stbi_set_flip_vertically_on_load(true);
+
+        ORMSource sources[ORMChannel_Count];
+        for (int channel = 0; channel < ORMChannel_Count; channel++) {
+            std::string sourcePath = getORMSourcePath(prefix, static_cast<ORMChannel>(channel));
+            int width, height, channels;
+            unsigned char* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 1);
+            if (!pixels) {
+                std::cout << "Missing " << sourcePath << ", using the default value" << std::endl;
+                continue;
+            }
+            sources[channel] = makeORMSource(pixels, width, height, 1);
+            stbi_image_free(pixels);
+        }
+
+        RawImage image;
+        image.channels = 3;
+        if (!packORM(sources, image.pixels, image.width, image.height)) {
+            std::cout << "No ORM source maps found for " << prefix << std::endl;
+            return false;
+        }
+
+        return writeMipChain(image, DDSFormat_BC1, false, cachePath, start);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool force = false;
+    int baked = 0;
+    int failed = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--force") == 0) {
+            force = true;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--orm") == 0 && i + 1 < argc) {
+            if (bakeORM(argv[++i], force)) baked++;
+            else failed++;
+            continue;
+        }
+        if (bakeTexture(argv[i], force)) baked++;
+        else failed++;
+    }
+
+    if (baked + failed == 0) {
+        std::cout << "Usage: TextureBaker [--force] [--orm <prefix>]... <image>..." << std::endl;
+        return 1;
+    }
+
+    std::cout << baked << " textures ready, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}